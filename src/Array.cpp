@@ -124,6 +124,12 @@ void Array::getList(ReferenceHolder<>& return_value, Env& env, jarray array, jcl
     return_value = l.release();
 }
 
+void Array::appendObjectList(QoreListNode* l, Env& env, jobjectArray array, QoreProgram* pgm, bool compat_types) {
+    for (jsize i = 0, e = env.getArrayLength(array); i < e; ++i) {
+        l->push(JavaToQore::convertToQore(env.getObjectArrayElement(array, i), pgm, compat_types), nullptr);
+    }
+}
+
 QoreValue Array::get(Env& env, jarray array, Type elementType, jclass elementClass, int64 index, QoreProgram* pgm,
         bool compat_types) {
     switch (elementType) {
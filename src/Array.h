@@ -84,6 +84,12 @@ class Array : public QoreJniPrivateData {
     DLLLOCAL static void getList(ReferenceHolder<>& return_value, Env& env, jarray array,
             jclass arrayClass, QoreProgram* pgm, bool compat_types = false, bool varargs = false);
 
+    //! converts the elements of an Object[] array and appends them to the given list
+    /** does not look up the array's element type, as the elements are always references
+     */
+    DLLLOCAL static void appendObjectList(QoreListNode* l, Env& env, jobjectArray array, QoreProgram* pgm,
+            bool compat_types = false);
+
     DLLLOCAL static QoreValue get(Env& env, jarray array, Type elementType, jclass elementClass, int64 index,
             QoreProgram* pgm, bool compat_types);
 
@@ -34,6 +34,8 @@
 #include <qore/Qore.h>
 
 #include <vector>
+#include <atomic>
+#include <algorithm>
 
 #include "LocalReference.h"
 #include "Object.h"
@@ -45,6 +47,7 @@ namespace jni {
 class Field;
 class Method;
 class BaseMethod;
+class QoreJniClassMapBase;
 
 /**
  * \brief Represents a Java class.
@@ -112,12 +115,63 @@ public:
         return mods & JVM_ACC_ABSTRACT;
     }
 
+    // returns true if the Qore class has been populated with methods and members from the Java class
+    DLLLOCAL bool isPopulated() const {
+        return populated.load(std::memory_order_acquire);
+    }
+
+    // marks the Qore class as populated; must only be called after all methods and members have been added
+    DLLLOCAL void setPopulated() {
+        populated.store(true, std::memory_order_release);
+    }
+
+    // returns true if population has started; must be called with the class map lock held
+    DLLLOCAL bool isPopulating() const {
+        return populating;
+    }
+
+    // marks the Qore class as being populated; returns false if population has already started; must be called
+    // with the class map lock held
+    DLLLOCAL bool setPopulating() {
+        if (populating) {
+            return false;
+        }
+        populating = true;
+        return true;
+    }
+
+    // adds a class map that holds a Qore class for this Java class until it is populated (lazy imports); must be
+    // called with the class map lock held
+    DLLLOCAL void addPendingOwner(QoreJniClassMapBase* owner) {
+        pending_owners.push_back(owner);
+    }
+
+    // removes a class map added with addPendingOwner(); must be called with the class map lock held
+    DLLLOCAL void removePendingOwner(QoreJniClassMapBase* owner) {
+        pending_owners.erase(std::remove(pending_owners.begin(), pending_owners.end(), owner),
+            pending_owners.end());
+    }
+
+    // returns and clears the class maps added with addPendingOwner(); must be called with the class map lock held
+    DLLLOCAL std::vector<QoreJniClassMapBase*> takePendingOwners() {
+        std::vector<QoreJniClassMapBase*> rv;
+        rv.swap(pending_owners);
+        return rv;
+    }
+
 private:
     GlobalReference<jclass> cls;
     // for tracking Method objects associated with this Class
     typedef std::vector<BaseMethod*> mlist_t;
     mlist_t mlist;
     int mods;
+    // set when the Qore class has been populated; with lazy imports this happens on first use
+    std::atomic<bool> populated = {false};
+    // set when population has started, to stop recursive population; protected by the class map lock
+    bool populating = false;
+    // class maps holding Qore classes for this Java class until it is populated (lazy imports); protected by the
+    // class map lock
+    std::vector<QoreJniClassMapBase*> pending_owners;
 
     DLLLOCAL int getModifiersIntern() const;
 };
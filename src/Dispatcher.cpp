@@ -25,12 +25,14 @@
 //------------------------------------------------------------------------------
 #include "Dispatcher.h"
 #include "Array.h"
+#include "Globals.h"
 #include "Method.h"
 #include "QoreToJava.h"
 
 namespace jni {
 
-QoreCodeDispatcher::QoreCodeDispatcher(const ResolvedCallReferenceNode *callback) : callback(callback->refRefSelf()) {
+QoreCodeDispatcher::QoreCodeDispatcher(const ResolvedCallReferenceNode *callback, bool pass_method_name)
+        : callback(callback->refRefSelf()), pass_method_name(pass_method_name) {
     pgm->ref();
     printd(LogLevel, "QoreCodeDispatcher::QoreCodeDispatcher(), this: %p\n", this);
 }
@@ -44,6 +46,8 @@ QoreCodeDispatcher::~QoreCodeDispatcher() {
     }
     printd(LogLevel, "QoreCodeDispatcher::~QoreCodeDispatcher(), this: %p\n", this);
     ExceptionSink xsink;
+    method_cache_lists.clear();
+    method_cache_entries.clear();
     callback->deref(&xsink);
     pgm->deref(&xsink);
     if (xsink) {
@@ -73,14 +77,15 @@ jobject QoreCodeDispatcher::dispatch(Env& env, jobject proxy, jobject method, jo
         JniExternalProgramData* jpc = jni_get_context_unconditional(pgm);
 
         ReferenceHolder<QoreListNode> args(new QoreListNode(autoTypeInfo), &xsink);
-        args->push(new QoreObject(QC_METHOD, pgm, new QoreJniPrivateData(method)), &xsink);
+        args->push(getMethodArg(env, method, pgm, &xsink), &xsink);
         if (jargs) {
             // we need to set the Program context if executing in a new thread
             // when creating arguments in case QoreClass
             // objects must be created from Java objects
             QoreExternalProgramCallContextHelper pch(pgm);
-            ReferenceHolder<> val(&xsink);
-            Array::getList(val, env, jargs, env.getObjectClass(jargs), pgm);
+            // proxy arguments are always passed as Object[], so the element type does not need to be looked up
+            ReferenceHolder<QoreListNode> val(new QoreListNode(autoTypeInfo), &xsink);
+            Array::appendObjectList(*val, env, jargs, pgm);
             args->push(val.release(), &xsink);
         }
 
@@ -107,4 +112,45 @@ jobject QoreCodeDispatcher::dispatch(Env& env, jobject proxy, jobject method, jo
     }
 }
 
+const std::string* QoreCodeDispatcher::findMethodName(Env& env, const method_cache_t* c, jobject method) {
+    if (c) {
+        for (const auto* i : *c) {
+            if (env.isSameObject(i->method, method)) {
+                return &i->name;
+            }
+        }
+    }
+    return nullptr;
+}
+
+QoreValue QoreCodeDispatcher::getMethodArg(Env& env, jobject method, QoreProgram* pgm, ExceptionSink* xsink) {
+    // Method objects are not shared between callbacks, as the callback can use or modify the object
+    if (!pass_method_name) {
+        return new QoreObject(QC_METHOD, pgm, new QoreJniPrivateData(method));
+    }
+
+    const std::string* cached_name = findMethodName(env, method_cache.load(std::memory_order_acquire), method);
+    if (cached_name) {
+        return new QoreStringNode(*cached_name, QCS_UTF8);
+    }
+
+    LocalReference<jstring> jname = env.callObjectMethod(method, Globals::methodMethodGetName, nullptr)
+        .as<jstring>();
+    Env::GetStringUtfChars chars(env, jname);
+    std::string name(chars.c_str());
+
+    AutoLocker al(method_cache_lock);
+    const method_cache_t* c = method_cache.load(std::memory_order_relaxed);
+    // another thread may have added the method in the meantime
+    if (!findMethodName(env, c, method) && (!c || c->size() < MaxMethodCacheSize)) {
+        method_cache_entries.emplace_back(new MethodCacheEntry{GlobalReference<jobject>::fromLocal(method), name});
+        method_cache_t* new_cache = c ? new method_cache_t(*c) : new method_cache_t;
+        new_cache->push_back(method_cache_entries.back().get());
+        method_cache_lists.emplace_back(new_cache);
+        // the previous list stays valid for concurrent readers until the dispatcher is destroyed
+        method_cache.store(new_cache, std::memory_order_release);
+    }
+    return new QoreStringNode(name, QCS_UTF8);
+}
+
 } // namespace jni
@@ -32,6 +32,12 @@
 #define QORE_JNI_DISPATCHER_H_
 
 #include "Env.h"
+#include "GlobalReference.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace jni {
 
@@ -58,14 +64,48 @@ private:
 class QoreCodeDispatcher : public Dispatcher {
 
 public:
-    QoreCodeDispatcher(const ResolvedCallReferenceNode* callback);
+    /**
+     * \brief Creates the dispatcher.
+     * \param callback the Qore code to call
+     * \param pass_method_name if true, the callback receives the name of the method as a string instead of the
+     * java.lang.reflect.Method object
+     */
+    QoreCodeDispatcher(const ResolvedCallReferenceNode* callback, bool pass_method_name = false);
     ~QoreCodeDispatcher();
 
     jobject dispatch(Env& env, jobject proxy, jobject method, jobjectArray args) override;
 
 private:
+    //! the maximum number of methods whose names are cached
+    static constexpr size_t MaxMethodCacheSize = 64;
+
+    struct MethodCacheEntry {
+        GlobalReference<jobject> method;
+        //! the method name passed to the callback
+        std::string name;
+    };
+
+    //! an immutable list of cached methods; replaced with a new list when a method is added
+    typedef std::vector<const MethodCacheEntry*> method_cache_t;
+
     QoreProgram* pgm = getProgram();
     ResolvedCallReferenceNode* callback;
+    bool pass_method_name;
+
+    //! the current list of cached method names; proxies pass the same Method object for each call, so callbacks
+    //! receiving the method name do not need to get it from Java on every call; read without locking
+    std::atomic<const method_cache_t*> method_cache = {nullptr};
+    //! owns the cache entries and all lists published in method_cache; freed in the destructor
+    std::vector<std::unique_ptr<MethodCacheEntry>> method_cache_entries;
+    std::vector<std::unique_ptr<const method_cache_t>> method_cache_lists;
+    //! serializes additions to the cache
+    QoreThreadLock method_cache_lock;
+
+    //! returns the cached name of the given method, if any
+    static const std::string* findMethodName(Env& env, const method_cache_t* c, jobject method);
+
+    //! returns the first callback argument for the given method: a new Method object or the method name
+    QoreValue getMethodArg(Env& env, jobject method, QoreProgram* pgm, ExceptionSink* xsink);
 };
 
 } // namespace jni
@@ -1002,6 +1002,16 @@ public:
         return env->IsInstanceOf(obj, cls) == JNI_TRUE;
     }
 
+    /**
+     * \brief Tests whether an object of one class can be assigned to a variable of another class.
+     * \param cls1 the class of the object
+     * \param cls2 the class of the variable
+     * \return true if cls1 can be cast to cls2
+     */
+    DLLLOCAL bool isAssignableFrom(jclass cls1, jclass cls2) {
+        return env->IsAssignableFrom(cls1, cls2) == JNI_TRUE;
+    }
+
     /**
      * \brief Creates a new Java object.
      * \param cls the class of the object
@@ -1026,6 +1036,21 @@ public:
         return s;
     }
 
+    /**
+     * \brief Creates a direct java.nio.ByteBuffer referring to the given memory without copying it.
+     * \param address the start of the memory region; must remain valid while the buffer is in use
+     * \param capacity the size of the memory region in bytes
+     * \return a reference to the new buffer
+     * \throws JavaException if the buffer cannot be created
+     */
+    DLLLOCAL LocalReference<jobject> newDirectByteBuffer(void* address, jlong capacity) {
+        jobject ret = env->NewDirectByteBuffer(address, capacity);
+        if (ret == nullptr) {
+            throw JavaException();
+        }
+        return ret;
+    }
+
     DLLLOCAL void registerNatives(jclass cls, const JNINativeMethod *methods, jint count) {
         if (env->RegisterNatives(cls, methods, count) != 0) {
             throw JavaException();
@@ -1180,6 +1205,62 @@ public:
         return value;
     }
 
+    DLLLOCAL void getBooleanArrayRegion(jbooleanArray array, jsize start, jsize len, jboolean* buf) {
+        env->GetBooleanArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void getIntArrayRegion(jintArray array, jsize start, jsize len, jint* buf) {
+        env->GetIntArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void getLongArrayRegion(jlongArray array, jsize start, jsize len, jlong* buf) {
+        env->GetLongArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void getDoubleArrayRegion(jdoubleArray array, jsize start, jsize len, jdouble* buf) {
+        env->GetDoubleArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void setBooleanArrayRegion(jbooleanArray array, jsize start, jsize len, const jboolean* buf) {
+        env->SetBooleanArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void setIntArrayRegion(jintArray array, jsize start, jsize len, const jint* buf) {
+        env->SetIntArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void setLongArrayRegion(jlongArray array, jsize start, jsize len, const jlong* buf) {
+        env->SetLongArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
+    DLLLOCAL void setDoubleArrayRegion(jdoubleArray array, jsize start, jsize len, const jdouble* buf) {
+        env->SetDoubleArrayRegion(array, start, len, buf);
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
     DLLLOCAL LocalReference<jobject> getObjectArrayElement(jobjectArray array, jsize index) {
         jobject o = env->GetObjectArrayElement(array, index);
         if (env->ExceptionCheck()) {
@@ -1202,6 +1283,13 @@ public:
         }
     }
 
+    DLLLOCAL void setByteArrayRegion(jbyteArray array, jsize start, jsize len, const void* buf) {
+        env->SetByteArrayRegion(array, start, len, reinterpret_cast<const jbyte*>(buf));
+        if (env->ExceptionCheck()) {
+            throw JavaException();
+        }
+    }
+
     DLLLOCAL void setCharArrayElement(jcharArray array, jsize index, jchar value) {
         env->SetCharArrayRegion(array, index, 1, &value);
         if (env->ExceptionCheck()) {
@@ -1317,6 +1405,8 @@ public:
         jclass c = env->FindClass(name);
         //if (c) { printd(5, "FOUND '%s': %p\n", name, c); }
         if (!c) {
+            // clear the NoClassDefFoundError raised by FindClass()
+            env->ExceptionClear();
             c = env->DefineClass(name, loader, reinterpret_cast<const jbyte*>(buf), bufLen);
             if (!c) {
                 throw JavaException();
@@ -32,6 +32,8 @@
 #include "Globals.h"
 #include "Env.h"
 #include "Dispatcher.h"
+#include "JavaFuture.h"
+#include "ParallelMap.h"
 #include "ModifiedUtf8String.h"
 #include "Array.h"
 #include "QoreToJava.h"
@@ -40,16 +42,19 @@
 #include <bzlib.h>
 #include <dlfcn.h>
 
+#include <memory>
+
 namespace jni {
 
 // Qore initialization flag
 bool jni_qore_init = false;
-bool jni_qore_init_done = false;
+std::atomic<bool> jni_qore_init_done(false);
 
 ExceptionSink Globals::global_xsink;
 std::unique_ptr<QoreProgramHelper> Globals::qph;
 
 bool Globals::already_initialized = false;
+bool Globals::classes_from_jar = false;
 
 GlobalReference<jobject> Globals::syscl;
 bool Globals::bootstrap = false;
@@ -138,9 +143,16 @@ jmethodID Globals::methodConstructorNewInstance;
 GlobalReference<jclass> Globals::classQoreInvocationHandler;
 jmethodID Globals::ctorQoreInvocationHandler;
 jmethodID Globals::methodQoreInvocationHandlerDestroy;
+jmethodID Globals::methodQoreInvocationHandlerStartAsync;
 
 GlobalReference<jclass> Globals::classQoreJavaApi;
-jmethodID Globals::methodQoreJavaApiGetStackTrace;
+jmethodID Globals::methodQoreJavaApiGetStackFrames;
+jmethodID Globals::methodQoreJavaApiSetStackTraceDepth;
+jmethodID Globals::methodQoreJavaApiSetStackTraceFilter;
+jmethodID Globals::methodQoreJavaApiSetExceptionStackDepth;
+jmethodID Globals::methodQoreJavaApiGetThrowableDescription;
+jmethodID Globals::methodQoreJavaApiGetThrowableInfo;
+jmethodID Globals::methodQoreJavaApiGetFunctionalMethod;
 
 GlobalReference<jclass> Globals::classQoreExceptionWrapper;
 jmethodID Globals::ctorQoreExceptionWrapper;
@@ -163,6 +175,19 @@ GlobalReference<jclass> Globals::classQoreClosure;
 jmethodID Globals::ctorQoreClosure;
 jmethodID Globals::methodQoreClosureGet;
 
+GlobalReference<jclass> Globals::classQoreTask;
+jmethodID Globals::ctorQoreTask;
+
+GlobalReference<jclass> Globals::classQoreMethodRef;
+GlobalReference<jclass> Globals::classQoreFunctionRef;
+GlobalReference<jclass> Globals::classQoreFutureListener;
+jmethodID Globals::methodQoreFutureListenerListen;
+
+GlobalReference<jclass> Globals::classQoreParallelMap;
+jmethodID Globals::methodQoreParallelMapMap;
+
+GlobalReference<jclass> Globals::classCompletionStage;
+
 GlobalReference<jclass> Globals::classQoreObjectWrapper;
 
 GlobalReference<jclass> Globals::classQoreClosureMarker;
@@ -171,6 +196,36 @@ GlobalReference<jclass> Globals::classQoreClosureMarkerImpl;
 GlobalReference<jclass> Globals::classQoreJavaObjectPtr;
 jmethodID Globals::ctorQoreJavaObjectPtr;
 
+GlobalReference<jclass> Globals::classJdbcBlockFetcher;
+jmethodID Globals::ctorJdbcBlockFetcher;
+jmethodID Globals::methodJdbcBlockFetcherFetch;
+jmethodID Globals::methodJdbcBlockFetcherGetNulls;
+jmethodID Globals::methodJdbcBlockFetcherGetLongs;
+jmethodID Globals::methodJdbcBlockFetcherGetDoubles;
+jmethodID Globals::methodJdbcBlockFetcherGetObjects;
+jmethodID Globals::methodJdbcBlockFetcherGetRowCount;
+jmethodID Globals::methodJdbcBlockFetcherGetColumnTypes;
+GlobalReference<jclass> Globals::classJdbcRowPrefetcher;
+jmethodID Globals::ctorJdbcRowPrefetcher;
+jmethodID Globals::methodJdbcRowPrefetcherTake;
+jmethodID Globals::methodJdbcRowPrefetcherStop;
+jmethodID Globals::methodJdbcRowPrefetcherClose;
+GlobalReference<jclass> Globals::classJdbcKeepalive;
+jmethodID Globals::ctorJdbcKeepalive;
+jmethodID Globals::methodJdbcKeepaliveSetBusy;
+jmethodID Globals::methodJdbcKeepaliveClose;
+GlobalReference<jclass> Globals::classJdbcLobStream;
+jmethodID Globals::methodJdbcLobStreamGet;
+GlobalReference<jclass> Globals::classJdbcBindStream;
+jmethodID Globals::ctorJdbcBindStreamBuffer;
+jmethodID Globals::ctorJdbcBindStreamObject;
+jmethodID Globals::methodJdbcBindStreamDetach;
+
+GlobalReference<jclass> Globals::classJdbcBatchBinder;
+jmethodID Globals::ctorJdbcBatchBinder;
+jmethodID Globals::methodJdbcBatchBinderBind;
+jmethodID Globals::methodJdbcBatchBinderToArray;
+
 GlobalReference<jclass> Globals::classProxy;
 jmethodID Globals::methodProxyNewProxyInstance;
 
@@ -337,6 +392,8 @@ jmethodID Globals::methodDatabaseMetaDataGetDriverVersion;
 
 GlobalReference<jclass> Globals::classPreparedStatement;
 jmethodID Globals::methodPreparedStatementAddBatch;
+jmethodID Globals::methodPreparedStatementClearBatch;
+jmethodID Globals::methodPreparedStatementClearParameters;
 jmethodID Globals::methodPreparedStatementClose;
 jmethodID Globals::methodPreparedStatementExecute;
 jmethodID Globals::methodPreparedStatementExecuteBatch;
@@ -348,7 +405,10 @@ jmethodID Globals::methodPreparedStatementSetBigDecimal;
 jmethodID Globals::methodPreparedStatementSetBoolean;
 jmethodID Globals::methodPreparedStatementSetByte;
 jmethodID Globals::methodPreparedStatementSetBytes;
+jmethodID Globals::methodPreparedStatementSetBinaryStream;
+jmethodID Globals::methodPreparedStatementSetBinaryStreamLength;
 jmethodID Globals::methodPreparedStatementSetDouble;
+jmethodID Globals::methodPreparedStatementSetFetchSize;
 jmethodID Globals::methodPreparedStatementSetInt;
 jmethodID Globals::methodPreparedStatementSetShort;
 jmethodID Globals::methodPreparedStatementSetLong;
@@ -373,17 +433,26 @@ jmethodID Globals::methodResultSetNext;
 jmethodID Globals::methodResultSetGetMetaData;
 jmethodID Globals::methodResultSetGetArray;
 jmethodID Globals::methodResultSetGetObject;
+jmethodID Globals::methodResultSetGetBoolean;
+jmethodID Globals::methodResultSetGetBytes;
+jmethodID Globals::methodResultSetGetDouble;
+jmethodID Globals::methodResultSetGetLong;
+jmethodID Globals::methodResultSetGetString;
+jmethodID Globals::methodResultSetGetTimestamp;
+jmethodID Globals::methodResultSetWasNull;
 
 GlobalReference<jclass> Globals::classResultSetMetaData;
 jmethodID Globals::methodResultSetMetaDataGetColumnClassName;
 jmethodID Globals::methodResultSetMetaDataGetColumnCount;
 jmethodID Globals::methodResultSetMetaDataGetColumnLabel;
 jmethodID Globals::methodResultSetMetaDataGetColumnType;
+jmethodID Globals::methodResultSetMetaDataIsSigned;
 
 GlobalReference<jclass> Globals::classArray;
 jmethodID Globals::methodArrayGetArray;
 
 GlobalReference<jclass> Globals::classSQLException;
+jmethodID Globals::methodSQLExceptionGetSQLState;
 
 GlobalReference<jclass> Globals::classServiceLoader;
 jmethodID Globals::methodServiceLoaderIterator;
@@ -392,6 +461,27 @@ GlobalReference<jclass> Globals::classDriver;
 
 int Globals::typeNull;
 int Globals::typeChar;
+int Globals::typeTinyInt;
+int Globals::typeSmallInt;
+int Globals::typeInteger;
+int Globals::typeBigInt;
+int Globals::typeReal;
+int Globals::typeFloat;
+int Globals::typeDouble;
+int Globals::typeBoolean;
+int Globals::typeVarchar;
+int Globals::typeLongVarchar;
+int Globals::typeNChar;
+int Globals::typeNVarchar;
+int Globals::typeLongNVarchar;
+int Globals::typeBinary;
+int Globals::typeVarBinary;
+int Globals::typeLongVarBinary;
+int Globals::typeTimestamp;
+int Globals::typeArray;
+int Globals::typeBlob;
+int Globals::typeClob;
+int Globals::typeNClob;
 
 GlobalReference<jstring> Globals::javaQoreClassField;
 
@@ -414,6 +504,40 @@ static jobject JNICALL invocation_handler_invoke(JNIEnv* jenv, jobject, jlong pt
     return dispatcher->dispatch(env, proxy, method, args);
 }
 
+// dispatches a batch of queued asynchronous calls; exceptions are returned in the errors array
+static void JNICALL invocation_handler_invoke_batch(JNIEnv* jenv, jclass, jlong ptr, jobjectArray proxies,
+        jobjectArray methods, jobjectArray args, jobjectArray errors, jint count) {
+    Env env(jenv);
+    Dispatcher* dispatcher = reinterpret_cast<Dispatcher*>(ptr);
+    for (jint i = 0; i < count; ++i) {
+        try {
+            LocalReference<jobject> proxy = env.getObjectArrayElement(proxies, i);
+            LocalReference<jobject> method = env.getObjectArrayElement(methods, i);
+            LocalReference<jobjectArray> call_args = env.getObjectArrayElement(args, i).as<jobjectArray>();
+            // the methods have no return value
+            LocalReference<jobject> rv = dispatcher->dispatch(env, proxy, method, call_args);
+            if (jenv->ExceptionCheck()) {
+                throw JavaException();
+            }
+        } catch (JavaException& e) {
+            LocalReference<jthrowable> throwable = e.save();
+            jenv->SetObjectArrayElement(errors, i, throwable);
+        } catch (jni::Exception& e) {
+            e.ignore();
+        }
+    }
+}
+
+// attaches a worker thread for asynchronous calls to Qore until it terminates
+static void JNICALL invocation_handler_attach(JNIEnv* jenv, jclass) {
+    Env env(jenv);
+    try {
+        qoreThreadAttacher.attach();
+    } catch (jni::Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+    }
+}
+
 static int save_object_thread(Env& env, const QoreValue& rv, QoreProgram* pgm, ExceptionSink& xsink) {
     QoreHashNode* data = pgm->getThreadData();
     assert(data);
@@ -754,6 +878,15 @@ static void JNICALL java_api_deregister_java_thread(JNIEnv* jenv, jobject obj) {
     q_deregister_foreign_thread();
 }
 
+static void JNICALL java_api_set_sticky_thread_attach(JNIEnv* jenv, jobject obj, jboolean enable) {
+    printd(5, "java_api_set_sticky_thread_attach(): %d\n", (int)enable);
+    jni_sticky_thread_attach = enable;
+}
+
+static jboolean JNICALL java_api_get_sticky_thread_attach(JNIEnv* jenv, jobject obj) {
+    return jni_sticky_thread_attach.load();
+}
+
 static void JNICALL qore_exception_wrapper_finalize(JNIEnv*, jclass, jlong ptr) {
     ExceptionSink* xsink = reinterpret_cast<ExceptionSink*>(ptr);
     //printd(LogLevel, "qore_exception_wrapper_finalize() xsink: %p\n", xsink);
@@ -938,6 +1071,27 @@ static jobject JNICALL qore_closure_call_save(JNIEnv* jenv, jclass jcls, QorePro
     return qore_object_closure_call_internal(jenv, jcls, pgm, obj_ptr, true, nullptr, args);
 }
 
+// calls the closure of a QoreTask; with sticky attachment (the task's default), the thread stays attached to Qore
+// until it terminates, so the threads of a Java thread pool are only attached once
+static jobject JNICALL qore_task_call(JNIEnv* jenv, jclass jcls, QoreProgram* pgm, jobject closure,
+        jboolean sticky) {
+    Env env(jenv);
+    QoreThreadAttachHelper attach_helper;
+    try {
+        attach_helper.attach(sticky || jni_sticky_thread_attach.load(std::memory_order_relaxed));
+    } catch (jni::Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+        return nullptr;
+    }
+
+    jlong ptr = jenv->CallLongMethod(closure, Globals::methodQoreClosureGet);
+    if (jenv->ExceptionCheck()) {
+        // the Java exception is thrown when this function returns
+        return nullptr;
+    }
+    return qore_object_closure_call_internal(jenv, jcls, pgm, ptr, false, nullptr, nullptr);
+}
+
 static void JNICALL qore_closure_finalize(JNIEnv*, jclass, jlong ptr) {
     assert(ptr);
     ResolvedCallReferenceNode* call = reinterpret_cast<ResolvedCallReferenceNode*>(ptr);
@@ -995,39 +1149,57 @@ static jobject JNICALL qore_object_get_member_value(JNIEnv* jenv, jobject jobj,
 }
 
 struct class_info_t {
+    // 0 if the class data is stored uncompressed
     unsigned compressed_len;
     unsigned len;
-    unsigned char* byte_code;
+    const unsigned char* byte_code;
 };
 
 typedef std::map<const char*, class_info_t, ltstr> cmap_t;
 
 DLLLOCAL extern cmap_t jar_cmap;
 
-static jbyteArray JNICALL qore_url_classloader_get_cached_class(JNIEnv* jenv, jclass jcls, jstring bin_name) {
-    Env env(jenv);
-    Env::GetStringUtfChars bname(env, bin_name);
+// cache of decompressed class data for compressed jar classes; keys are the names in jar_cmap
+typedef std::map<const char*, std::unique_ptr<unsigned char[]>> jar_dcmap_t;
+static jar_dcmap_t jar_dcmap;
+static QoreThreadLock jar_dcmap_lock;
 
-    cmap_t::const_iterator i = jar_cmap.find(bname.c_str());
-    if (i == jar_cmap.end()) {
-        //printd(LogLevel, "qore_url_classloader_get_cached_class() '%s' not found\n", bname.c_str());
-        return nullptr;
+// returns a pointer to the uncompressed class data, decompressing it only on the first lookup
+static const unsigned char* get_jar_class_data(cmap_t::const_iterator i) {
+    if (!i->second.compressed_len) {
+        return i->second.byte_code;
+    }
+
+    AutoLocker al(jar_dcmap_lock);
+    jar_dcmap_t::iterator di = jar_dcmap.lower_bound(i->first);
+    if (di != jar_dcmap.end() && di->first == i->first) {
+        return di->second.get();
     }
 
     // decompress class data
-    SimpleRefHolder<BinaryNode> b(new BinaryNode);
-    b->preallocate(i->second.len);
+    std::unique_ptr<unsigned char[]> buf(new unsigned char[i->second.len]);
     unsigned size = i->second.len;
-    int rc = BZ2_bzBuffToBuffDecompress((char*)b->getPtr(), &size, (char*)i->second.byte_code,
+    int rc = BZ2_bzBuffToBuffDecompress((char*)buf.get(), &size, (char*)i->second.byte_code,
         i->second.compressed_len, 0, 0);
     assert(!rc);
     assert(size == i->second.len);
 
-    LocalReference<jbyteArray> array = env.newByteArray(b->size()).as<jbyteArray>();
-    for (jsize j = 0; j < static_cast<jsize>(i->second.len); ++j) {
-        env.setByteArrayElement(array, j, ((const char*)b->getPtr())[j]);
+    return jar_dcmap.insert(di, jar_dcmap_t::value_type(i->first, std::move(buf)))->second.get();
+}
+
+static jbyteArray JNICALL qore_url_classloader_get_cached_class(JNIEnv* jenv, jclass jcls, jstring bin_name) {
+    Env env(jenv);
+    Env::GetStringUtfChars bname(env, bin_name);
+
+    cmap_t::const_iterator i = jar_cmap.find(bname.c_str());
+    if (i == jar_cmap.end()) {
+        //printd(LogLevel, "qore_url_classloader_get_cached_class() '%s' not found\n", bname.c_str());
+        return nullptr;
     }
 
+    LocalReference<jbyteArray> array = env.newByteArray(i->second.len).as<jbyteArray>();
+    env.setByteArrayRegion(array, 0, i->second.len, get_jar_class_data(i));
+
     //printd(LogLevel, "qore_url_classloader_get_cached_class() FOUND '%s'\n", bname.c_str());
     return array.release();
 }
@@ -1085,10 +1257,8 @@ static jobject JNICALL java_class_builder_do_static_call(JNIEnv* jenv, jclass jc
         reinterpret_cast<const QoreExternalMethodVariant*>(vptr));
 }
 
-static jobject JNICALL java_class_builder_do_function_call(JNIEnv* jenv, jclass jcls, QoreProgram* pgm,
-        const QoreExternalFunction* func, const QoreExternalMethodVariant* v, jobjectArray args) {
-    printd(5, "java_class_builder_do_function_call() %s() v: %p args: %p\n", func->getName(), v, args);
-
+static jobject qore_function_call_internal(JNIEnv* jenv, QoreProgram* pgm, const QoreExternalFunction* func,
+        const QoreExternalMethodVariant* v, jboolean save, jobjectArray args, bool varargs) {
     assert(pgm);
     assert(func);
 
@@ -1117,7 +1287,7 @@ static jobject JNICALL java_class_builder_do_function_call(JNIEnv* jenv, jclass
     ReferenceHolder<QoreListNode> qore_args(&xsink);
 
     if (len) {
-        Array::getArgList(qore_args, env, args, pgm, true);
+        Array::getArgList(qore_args, env, args, pgm, varargs);
     }
 
     ValueHolder rv(func->evalFunction(v, *qore_args, pgm, &xsink), &xsink);
@@ -1126,7 +1296,7 @@ static jobject JNICALL java_class_builder_do_function_call(JNIEnv* jenv, jclass
         return nullptr;
     }
 
-    if (save_object(env, *rv, pgm, xsink)) {
+    if (save && save_object(env, *rv, pgm, xsink)) {
         return nullptr;
     }
 
@@ -1139,6 +1309,265 @@ static jobject JNICALL java_class_builder_do_function_call(JNIEnv* jenv, jclass
     }
 }
 
+static jobject JNICALL java_class_builder_do_function_call(JNIEnv* jenv, jclass jcls, QoreProgram* pgm,
+        const QoreExternalFunction* func, const QoreExternalMethodVariant* v, jobjectArray args) {
+    printd(5, "java_class_builder_do_function_call() %s() v: %p args: %p\n", func->getName(), v, args);
+    return qore_function_call_internal(jenv, pgm, func, v, true, args, true);
+}
+
+// a method resolved for a QoreMethodRef, owned by the Java object
+class QoreMethodRefInfo {
+public:
+    DLLLOCAL QoreMethodRefInfo(const QoreMethod* m) : m(m) {
+    }
+
+    DLLLOCAL const QoreMethod* getMethod() const {
+        return m;
+    }
+
+    // returns the method to call for the given object's class, which is an override of the resolved method if the
+    // object's class is a subclass that overrides it
+    DLLLOCAL const QoreMethod* getMethod(const QoreObject* obj) {
+        const QoreClass* cls = obj->getClass();
+        if (cls == m->getClass()) {
+            return m;
+        }
+        qore_classid_t id = cls->getID();
+        AutoLocker al(l);
+        override_map_t::const_iterator i = override_map.find(id);
+        if (i != override_map.end()) {
+            return i->second;
+        }
+        const QoreMethod* rv = cls->findMethod(m->getName());
+        if (!rv) {
+            rv = m;
+        }
+        override_map.insert(override_map_t::value_type(id, rv));
+        return rv;
+    }
+
+private:
+    const QoreMethod* m;
+    // methods to call for subclasses of the resolved method's class, keyed by class ID
+    typedef std::map<qore_classid_t, const QoreMethod*> override_map_t;
+    override_map_t override_map;
+    QoreThreadLock l;
+};
+
+// private native static long resolveMethod0(long pgm_ptr, long obj_ptr, String class_name, String name,
+//     boolean is_static);
+static jlong JNICALL qore_method_ref_resolve(JNIEnv* jenv, jclass, jlong ptr, jlong obj_ptr, jstring class_name,
+        jstring method_name, jboolean is_static) {
+    Env env(jenv);
+    QoreThreadAttachHelper attach_helper;
+    try {
+        attach_helper.attach();
+    } catch (Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+        return 0;
+    }
+
+    QoreProgram* pgm = reinterpret_cast<QoreProgram*>(ptr);
+
+    ExceptionSink xsink;
+    QoreExternalProgramContextHelper epch(&xsink, pgm);
+    if (xsink) {
+        QoreToJava::wrapException(env, xsink);
+        return 0;
+    }
+
+    try {
+        const QoreClass* cls;
+        if (obj_ptr) {
+            cls = reinterpret_cast<QoreObject*>(obj_ptr)->getClass();
+        } else {
+            Env::GetStringUtfChars cname(env, class_name);
+
+            // grab the current Program's parse lock before calling QoreProgram::findClass()
+            CurrentProgramRuntimeExternalParseContextHelper pch;
+
+            cls = pgm->findClass(cname.c_str(), &xsink);
+            if (!cls) {
+                if (!xsink) {
+                    xsink.raiseException("UNKNOWN-CLASS", "cannot resolve class '%s'", cname.c_str());
+                }
+                QoreToJava::wrapException(env, xsink);
+                return 0;
+            }
+        }
+
+        Env::GetStringUtfChars mname(env, method_name);
+        const QoreMethod* m = is_static
+            ? cls->findStaticMethod(mname.c_str())
+            : cls->findMethod(mname.c_str());
+        if (!m) {
+            xsink.raiseException("UNKNOWN-METHOD", "cannot resolve %smethod '%s::%s()'", is_static ? "static " : "",
+                cls->getName(), mname.c_str());
+            QoreToJava::wrapException(env, xsink);
+            return 0;
+        }
+        printd(5, "qore_method_ref_resolve() resolved %s::%s() (static: %d): %p\n", cls->getName(), mname.c_str(),
+            (int)is_static, m);
+        return reinterpret_cast<jlong>(new QoreMethodRefInfo(m));
+    } catch (jni::Exception& e) {
+        e.convert(&xsink);
+        QoreToJava::wrapException(env, xsink);
+        return 0;
+    }
+}
+
+static jobject qore_method_ref_call_internal(JNIEnv* jenv, jclass jcls, jlong ptr, jlong method_ptr,
+        jlong obj_ptr, jboolean save, jobjectArray args) {
+    QoreMethodRefInfo* info = reinterpret_cast<QoreMethodRefInfo*>(method_ptr);
+    const QoreMethod* m = info->getMethod();
+    QoreObject* obj = reinterpret_cast<QoreObject*>(obj_ptr);
+    assert(m);
+
+    // the method was resolved without an object, so the object's class has to be checked here
+    if (!obj || !obj->validInstanceOf(*m->getClass())) {
+        Env env(jenv);
+        QoreStringMaker desc("cannot call %s::%s() on an object of class '%s'", m->getClassName(), m->getName(),
+            obj ? obj->getClassName() : "<null>");
+        env.throwNew(env.findClass("java/lang/IllegalArgumentException"), desc.c_str());
+        return nullptr;
+    }
+
+    // call any override in the object's class, as with a normal method call
+    m = info->getMethod(obj);
+
+    return qore_object_closure_call_internal(jenv, jcls, reinterpret_cast<QoreProgram*>(ptr), obj_ptr, save,
+        nullptr, args, m);
+}
+
+static jobject JNICALL qore_method_ref_call(JNIEnv* jenv, jclass jcls, jlong ptr, jlong method_ptr, jlong obj_ptr,
+        jobjectArray args) {
+    return qore_method_ref_call_internal(jenv, jcls, ptr, method_ptr, obj_ptr, false, args);
+}
+
+static jobject JNICALL qore_method_ref_call_save(JNIEnv* jenv, jclass jcls, jlong ptr, jlong method_ptr,
+        jlong obj_ptr, jobjectArray args) {
+    return qore_method_ref_call_internal(jenv, jcls, ptr, method_ptr, obj_ptr, true, args);
+}
+
+static jobject JNICALL qore_method_ref_call_static(JNIEnv* jenv, jclass, jlong ptr, jlong method_ptr,
+        jobjectArray args) {
+    const QoreMethod* m = reinterpret_cast<QoreMethodRefInfo*>(method_ptr)->getMethod();
+    return java_api_call_static_method_internal(jenv, nullptr, ptr, false, nullptr, nullptr, args, m->getClass(), m);
+}
+
+static jobject JNICALL qore_method_ref_call_static_save(JNIEnv* jenv, jclass, jlong ptr, jlong method_ptr,
+        jobjectArray args) {
+    const QoreMethod* m = reinterpret_cast<QoreMethodRefInfo*>(method_ptr)->getMethod();
+    return java_api_call_static_method_internal(jenv, nullptr, ptr, true, nullptr, nullptr, args, m->getClass(), m);
+}
+
+static void JNICALL qore_method_ref_finalize(JNIEnv*, jclass, jlong method_ptr) {
+    delete reinterpret_cast<QoreMethodRefInfo*>(method_ptr);
+}
+
+// private native static long resolveFunction0(long pgm_ptr, String name);
+static jlong JNICALL qore_function_ref_resolve(JNIEnv* jenv, jclass, jlong ptr, jstring name) {
+    Env env(jenv);
+    QoreThreadAttachHelper attach_helper;
+    try {
+        attach_helper.attach();
+    } catch (Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+        return 0;
+    }
+
+    QoreProgram* pgm = reinterpret_cast<QoreProgram*>(ptr);
+
+    ExceptionSink xsink;
+    QoreExternalProgramContextHelper epch(&xsink, pgm);
+    if (xsink) {
+        QoreToJava::wrapException(env, xsink);
+        return 0;
+    }
+
+    try {
+        Env::GetStringUtfChars fname(env, name);
+
+        const QoreExternalFunction* func;
+        {
+            // grab the current Program's parse lock before looking up the function
+            CurrentProgramRuntimeExternalParseContextHelper pch;
+            func = pgm->findFunction(fname.c_str());
+        }
+        if (!func) {
+            xsink.raiseException("UNKNOWN-FUNCTION", "cannot resolve function '%s()'", fname.c_str());
+            QoreToJava::wrapException(env, xsink);
+            return 0;
+        }
+        printd(5, "qore_function_ref_resolve() resolved %s(): %p\n", fname.c_str(), func);
+        return reinterpret_cast<jlong>(func);
+    } catch (jni::Exception& e) {
+        e.convert(&xsink);
+        QoreToJava::wrapException(env, xsink);
+        return 0;
+    }
+}
+
+static jobject JNICALL qore_function_ref_call(JNIEnv* jenv, jclass, jlong ptr, jlong func_ptr,
+        jobjectArray args) {
+    return qore_function_call_internal(jenv, reinterpret_cast<QoreProgram*>(ptr),
+        reinterpret_cast<const QoreExternalFunction*>(func_ptr), nullptr, false, args, false);
+}
+
+static jobject JNICALL qore_function_ref_call_save(JNIEnv* jenv, jclass, jlong ptr, jlong func_ptr,
+        jobjectArray args) {
+    return qore_function_call_internal(jenv, reinterpret_cast<QoreProgram*>(ptr),
+        reinterpret_cast<const QoreExternalFunction*>(func_ptr), nullptr, true, args, false);
+}
+
+// called in the thread that completes a CompletionStage
+static void JNICALL qore_future_listener_complete(JNIEnv* jenv, jclass, jlong ptr, jobject result,
+        jthrowable error) {
+    Env env(jenv);
+
+    QoreThreadAttachHelper attach_helper;
+    try {
+        attach_helper.attach();
+    } catch (Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+        return;
+    }
+
+    JavaFuture* future = reinterpret_cast<JavaFuture*>(ptr);
+    future->complete(result, error);
+
+    // release the reference held by the Java callback
+    ExceptionSink xsink;
+    future->deref(&xsink);
+    if (xsink) {
+        QoreToJava::wrapException(env, xsink);
+    }
+}
+
+// called in the keepalive thread when a JDBC connection is found to be invalid
+static void JNICALL jdbc_keepalive_set_invalid(JNIEnv*, jclass, jlong ptr) {
+    reinterpret_cast<std::atomic<bool>*>(ptr)->store(true, std::memory_order_release);
+}
+
+static void JNICALL qore_parallel_map_start(JNIEnv*, jclass, jlong ptr, jlong size) {
+    reinterpret_cast<ParallelMap*>(ptr)->start((size_t)size);
+}
+
+static jboolean JNICALL qore_parallel_map_apply(JNIEnv* jenv, jclass, jlong ptr, jobject value, jlong pos) {
+    Env env(jenv);
+
+    // worker threads are normally attached when they start
+    QoreThreadAttachHelper attach_helper;
+    try {
+        attach_helper.attach();
+    } catch (Exception& e) {
+        env.throwNew(env.findClass("java/lang/RuntimeException"), "Unable to attach thread to Qore");
+        return JNI_FALSE;
+    }
+
+    return reinterpret_cast<ParallelMap*>(ptr)->apply(env, value, pos) ? JNI_TRUE : JNI_FALSE;
+}
+
 static jobject JNICALL java_class_builder_get_constant_value(JNIEnv* jenv, jclass jcls, QoreProgram* pgm,
         const QoreExternalConstant* constant_entry) {
     assert(pgm);
@@ -1936,12 +2365,22 @@ static GlobalReference<jclass> getPrimitiveClass(Env& env, const char* wrapperNa
 }
 
 #include "JavaClassQoreInvocationHandler.inc"
+#include "JavaClassQoreAsyncCall.inc"
+#include "JavaClassQoreAsyncPool.inc"
+#include "JavaClassQoreAsyncWorker.inc"
 #include "JavaClassQoreExceptionWrapper.inc"
 #include "JavaClassQoreException.inc"
 #include "JavaClassQoreObjectBase.inc"
 #include "JavaClassQoreObject.inc"
 #include "JavaClassQoreJavaClassBase.inc"
 #include "JavaClassQoreClosure.inc"
+#include "JavaClassQoreTask.inc"
+#include "JavaClassQoreMethodRef.inc"
+#include "JavaClassQoreFunctionRef.inc"
+#include "JavaClassQoreFutureListener.inc"
+#include "JavaClassQoreParallelMap.inc"
+#include "JavaClassQoreParallelMapJob.inc"
+#include "JavaClassQoreParallelMapThread.inc"
 #include "JavaClassQoreObjectWrapper.inc"
 #include "JavaClassQoreClosureMarker.inc"
 #include "JavaClassQoreClosureMarkerImpl.inc"
@@ -1952,11 +2391,18 @@ static GlobalReference<jclass> getPrimitiveClass(Env& env, const char* wrapperNa
 #include "JavaClassQoreURLClassLoader_2.inc"
 #include "JavaClassQoreJavaFileObject.inc"
 #include "JavaClassQoreJavaObjectPtr.inc"
+#include "JavaClassJdbcBlockFetcher.inc"
+#include "JavaClassJdbcBatchBinder.inc"
+#include "JavaClassJdbcRowPrefetcher.inc"
+#include "JavaClassJdbcKeepalive.inc"
+#include "JavaClassJdbcLobStream.inc"
+#include "JavaClassJdbcBindStream.inc"
 #include "JavaClassJavaClassBuilder.inc"
 #include "JavaClassJavaClassBuilder_1.inc"
 #include "JavaClassJavaClassBuilder_2.inc"
 #include "JavaClassStaticEntry.inc"
 #include "JavaClassQoreJavaApi.inc"
+#include "JavaClassQoreJavaApi_1.inc"
 #include "JavaClassQoreRelativeTime.inc"
 #include "JavaClassQoreJavaDynamicApi.inc"
 #include "JavaClassHash.inc"
@@ -2012,14 +2458,31 @@ static ucmap_t ucmap = {
     {"org.qore.jni.JavaClassBuilder", {java_org_qore_jni_JavaClassBuilder_class_len, java_org_qore_jni_JavaClassBuilder_class}},
     {"org.qore.jni.JavaClassBuilder$1", {java_org_qore_jni_JavaClassBuilder_1_class_len, java_org_qore_jni_JavaClassBuilder_1_class}},
     {"org.qore.jni.JavaClassBuilder$2", {java_org_qore_jni_JavaClassBuilder_2_class_len, java_org_qore_jni_JavaClassBuilder_2_class}},
+    {"org.qore.jni.JdbcBatchBinder", {java_org_qore_jni_JdbcBatchBinder_class_len, java_org_qore_jni_JdbcBatchBinder_class}},
+    {"org.qore.jni.JdbcBlockFetcher", {java_org_qore_jni_JdbcBlockFetcher_class_len, java_org_qore_jni_JdbcBlockFetcher_class}},
+    {"org.qore.jni.JdbcRowPrefetcher", {java_org_qore_jni_JdbcRowPrefetcher_class_len, java_org_qore_jni_JdbcRowPrefetcher_class}},
+    {"org.qore.jni.JdbcKeepalive", {java_org_qore_jni_JdbcKeepalive_class_len, java_org_qore_jni_JdbcKeepalive_class}},
+    {"org.qore.jni.JdbcLobStream", {java_org_qore_jni_JdbcLobStream_class_len, java_org_qore_jni_JdbcLobStream_class}},
+    {"org.qore.jni.JdbcBindStream", {java_org_qore_jni_JdbcBindStream_class_len, java_org_qore_jni_JdbcBindStream_class}},
+    {"org.qore.jni.QoreAsyncCall", {java_org_qore_jni_QoreAsyncCall_class_len, java_org_qore_jni_QoreAsyncCall_class}},
+    {"org.qore.jni.QoreAsyncPool", {java_org_qore_jni_QoreAsyncPool_class_len, java_org_qore_jni_QoreAsyncPool_class}},
+    {"org.qore.jni.QoreAsyncWorker", {java_org_qore_jni_QoreAsyncWorker_class_len, java_org_qore_jni_QoreAsyncWorker_class}},
     {"org.qore.jni.StaticEntry", {java_org_qore_jni_StaticEntry_class_len, java_org_qore_jni_StaticEntry_class}},
     {"org.qore.jni.QoreClosure", {java_org_qore_jni_QoreClosure_class_len, java_org_qore_jni_QoreClosure_class}},
+    {"org.qore.jni.QoreTask", {java_org_qore_jni_QoreTask_class_len, java_org_qore_jni_QoreTask_class}},
+    {"org.qore.jni.QoreMethodRef", {java_org_qore_jni_QoreMethodRef_class_len, java_org_qore_jni_QoreMethodRef_class}},
+    {"org.qore.jni.QoreFunctionRef", {java_org_qore_jni_QoreFunctionRef_class_len, java_org_qore_jni_QoreFunctionRef_class}},
+    {"org.qore.jni.QoreFutureListener", {java_org_qore_jni_QoreFutureListener_class_len, java_org_qore_jni_QoreFutureListener_class}},
+    {"org.qore.jni.QoreParallelMap", {java_org_qore_jni_QoreParallelMap_class_len, java_org_qore_jni_QoreParallelMap_class}},
+    {"org.qore.jni.QoreParallelMapJob", {java_org_qore_jni_QoreParallelMapJob_class_len, java_org_qore_jni_QoreParallelMapJob_class}},
+    {"org.qore.jni.QoreParallelMapThread", {java_org_qore_jni_QoreParallelMapThread_class_len, java_org_qore_jni_QoreParallelMapThread_class}},
     {"org.qore.jni.QoreClosureMarker", {java_org_qore_jni_QoreClosureMarker_class_len, java_org_qore_jni_QoreClosureMarker_class}},
     {"org.qore.jni.QoreClosureMarkerImpl", {java_org_qore_jni_QoreClosureMarkerImpl_class_len, java_org_qore_jni_QoreClosureMarkerImpl_class}},
     {"org.qore.jni.QoreException", {java_org_qore_jni_QoreException_class_len, java_org_qore_jni_QoreException_class}},
     {"org.qore.jni.QoreExceptionWrapper", {java_org_qore_jni_QoreExceptionWrapper_class_len, java_org_qore_jni_QoreExceptionWrapper_class}},
     {"org.qore.jni.QoreInvocationHandler", {java_org_qore_jni_QoreInvocationHandler_class_len, java_org_qore_jni_QoreInvocationHandler_class}},
     {"org.qore.jni.QoreJavaApi", {java_org_qore_jni_QoreJavaApi_class_len, java_org_qore_jni_QoreJavaApi_class}},
+    {"org.qore.jni.QoreJavaApi$1", {java_org_qore_jni_QoreJavaApi_1_class_len, java_org_qore_jni_QoreJavaApi_1_class}},
     {"org.qore.jni.QoreJavaClassBase", {java_org_qore_jni_QoreJavaClassBase_class_len, java_org_qore_jni_QoreJavaClassBase_class}},
     {"org.qore.jni.QoreJavaDynamicApi", {java_org_qore_jni_QoreJavaDynamicApi_class_len, java_org_qore_jni_QoreJavaDynamicApi_class}},
     {"org.qore.jni.QoreJavaFileObject", {java_org_qore_jni_QoreJavaFileObject_class_len, java_org_qore_jni_QoreJavaFileObject_class}},
@@ -2054,9 +2517,7 @@ static jbyteArray qore_url_classloader_get_internal_class(JNIEnv* jenv, jclass j
     }
 
     LocalReference<jbyteArray> array = env.newByteArray(i->second.len).as<jbyteArray>();
-    for (jsize j = 0; j < static_cast<jsize>(i->second.len); ++j) {
-        env.setByteArrayElement(array, j, i->second.byte_code[j]);
-    }
+    env.setByteArrayRegion(array, 0, i->second.len, i->second.byte_code);
 
     //printd(LogLevel, "qore_url_classloader_get_internal_class() FOUND '%s'\n", bname.c_str());
     return array.release();
@@ -2118,7 +2579,7 @@ static jobject JNICALL qore_url_classloader_get_internal_classes_for_package(JNI
     return nullptr;
 }
 
-static JNINativeMethod invocationHandlerNativeMethods[2] = {
+static JNINativeMethod invocationHandlerNativeMethods[] = {
     {
         const_cast<char*>("finalize0"),
         const_cast<char*>("(J)V"),
@@ -2128,7 +2589,18 @@ static JNINativeMethod invocationHandlerNativeMethods[2] = {
         const_cast<char*>("invoke0"),
         const_cast<char*>("(JLjava/lang/Object;Ljava/lang/reflect/Method;[Ljava/lang/Object;)Ljava/lang/Object;"),
         reinterpret_cast<void*>(invocation_handler_invoke)
-    }
+    },
+    {
+        const_cast<char*>("invokeBatch0"),
+        const_cast<char*>("(J[Ljava/lang/Object;[Ljava/lang/reflect/Method;[[Ljava/lang/Object;"
+            "[Ljava/lang/Throwable;I)V"),
+        reinterpret_cast<void*>(invocation_handler_invoke_batch)
+    },
+    {
+        const_cast<char*>("attach0"),
+        const_cast<char*>("()V"),
+        reinterpret_cast<void*>(invocation_handler_attach)
+    },
 };
 
 static JNINativeMethod qoreJavaApiNativeMethods[] = {
@@ -2180,6 +2652,18 @@ static JNINativeMethod qoreJavaApiNativeMethods[] = {
         const_cast<char*>("()V"),
         reinterpret_cast<void*>(java_api_deregister_java_thread)
     },
+    {
+        // private native static void setStickyThreadAttach0(boolean enable);
+        const_cast<char*>("setStickyThreadAttach0"),
+        const_cast<char*>("(Z)V"),
+        reinterpret_cast<void*>(java_api_set_sticky_thread_attach)
+    },
+    {
+        // private native static boolean getStickyThreadAttach0();
+        const_cast<char*>("getStickyThreadAttach0"),
+        const_cast<char*>("()Z"),
+        reinterpret_cast<void*>(java_api_get_sticky_thread_attach)
+    },
 };
 
 static JNINativeMethod qoreExceptionWrapperNativeMethods[] = {
@@ -2264,6 +2748,94 @@ static JNINativeMethod qoreClosureNativeMethods[] = {
     },
 };
 
+static JNINativeMethod qoreTaskNativeMethods[] = {
+    {
+        const_cast<char*>("call0"),
+        const_cast<char*>("(JLorg/qore/jni/QoreClosure;Z)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_task_call)
+    },
+};
+
+static JNINativeMethod qoreMethodRefNativeMethods[] = {
+    {
+        const_cast<char*>("resolveMethod0"),
+        const_cast<char*>("(JJLjava/lang/String;Ljava/lang/String;Z)J"),
+        reinterpret_cast<void*>(qore_method_ref_resolve)
+    },
+    {
+        const_cast<char*>("call0"),
+        const_cast<char*>("(JJJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_method_ref_call)
+    },
+    {
+        const_cast<char*>("callSave0"),
+        const_cast<char*>("(JJJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_method_ref_call_save)
+    },
+    {
+        const_cast<char*>("callStatic0"),
+        const_cast<char*>("(JJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_method_ref_call_static)
+    },
+    {
+        const_cast<char*>("callStaticSave0"),
+        const_cast<char*>("(JJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_method_ref_call_static_save)
+    },
+    {
+        const_cast<char*>("finalize0"),
+        const_cast<char*>("(J)V"),
+        reinterpret_cast<void*>(qore_method_ref_finalize)
+    },
+};
+
+static JNINativeMethod qoreFunctionRefNativeMethods[] = {
+    {
+        const_cast<char*>("resolveFunction0"),
+        const_cast<char*>("(JLjava/lang/String;)J"),
+        reinterpret_cast<void*>(qore_function_ref_resolve)
+    },
+    {
+        const_cast<char*>("call0"),
+        const_cast<char*>("(JJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_function_ref_call)
+    },
+    {
+        const_cast<char*>("callSave0"),
+        const_cast<char*>("(JJ[Ljava/lang/Object;)Ljava/lang/Object;"),
+        reinterpret_cast<void*>(qore_function_ref_call_save)
+    },
+};
+
+static JNINativeMethod qoreFutureListenerNativeMethods[] = {
+    {
+        const_cast<char*>("complete0"),
+        const_cast<char*>("(JLjava/lang/Object;Ljava/lang/Throwable;)V"),
+        reinterpret_cast<void*>(qore_future_listener_complete)
+    },
+};
+
+static JNINativeMethod qoreParallelMapNativeMethods[] = {
+    {
+        const_cast<char*>("start0"),
+        const_cast<char*>("(JJ)V"),
+        reinterpret_cast<void*>(qore_parallel_map_start)
+    },
+    {
+        const_cast<char*>("apply0"),
+        const_cast<char*>("(JLjava/lang/Object;J)Z"),
+        reinterpret_cast<void*>(qore_parallel_map_apply)
+    },
+};
+
+static JNINativeMethod jdbcKeepaliveNativeMethods[] = {
+    {
+        const_cast<char*>("setInvalid0"),
+        const_cast<char*>("(J)V"),
+        reinterpret_cast<void*>(jdbc_keepalive_set_invalid)
+    },
+};
+
 static JNINativeMethod qoreURLClassLoaderNativeMethods[] = {
     {
         const_cast<char*>("getCachedClass0"),
@@ -2347,7 +2919,8 @@ LocalReference<jclass> Globals::findDefineClass(Env& env, const char* name, jobj
     if (!loader) {
         QoreString jname(name);
         jname.replaceAll(".", "/");
-        if (already_initialized) {
+        // classes loaded from a jar on the class path can be stored in a class data sharing archive
+        if (already_initialized || classes_from_jar) {
             return env.findDefineClass(jname.c_str(), nullptr, buf, bufLen);
         } else {
             return env.defineClass(jname.c_str(), nullptr, buf, bufLen);
@@ -2355,9 +2928,7 @@ LocalReference<jclass> Globals::findDefineClass(Env& env, const char* name, jobj
     } else {
         std::vector<jvalue> jargs(2);
         LocalReference<jbyteArray> jbyte_code = env.newByteArray(bufLen).as<jbyteArray>();
-        for (jsize i = 0; i < static_cast<jsize>(bufLen); ++i) {
-            env.setByteArrayElement(jbyte_code, i, ((const char*)buf)[i]);
-        }
+        env.setByteArrayRegion(jbyte_code, 0, bufLen, buf);
 
         LocalReference<jstring> bname = env.newString(name);
         jargs[0].l = bname;
@@ -2578,6 +3149,31 @@ bool Globals::init() {
     ctorQoreClosure = env.getMethod(classQoreClosure, "<init>", "(J)V");
     methodQoreClosureGet = env.getMethod(classQoreClosure, "get", "()J");
 
+    classQoreTask = findDefineClass(env, "org.qore.jni.QoreTask", nullptr, java_org_qore_jni_QoreTask_class,
+        java_org_qore_jni_QoreTask_class_len).makeGlobal();
+    env.registerNatives(classQoreTask, qoreTaskNativeMethods,
+        sizeof(qoreTaskNativeMethods) / sizeof(JNINativeMethod));
+    ctorQoreTask = env.getMethod(classQoreTask, "<init>", "(JLorg/qore/jni/QoreClosure;)V");
+
+    classQoreMethodRef = findDefineClass(env, "org.qore.jni.QoreMethodRef", nullptr,
+        java_org_qore_jni_QoreMethodRef_class, java_org_qore_jni_QoreMethodRef_class_len).makeGlobal();
+    env.registerNatives(classQoreMethodRef, qoreMethodRefNativeMethods,
+        sizeof(qoreMethodRefNativeMethods) / sizeof(JNINativeMethod));
+
+    classQoreFunctionRef = findDefineClass(env, "org.qore.jni.QoreFunctionRef", nullptr,
+        java_org_qore_jni_QoreFunctionRef_class, java_org_qore_jni_QoreFunctionRef_class_len).makeGlobal();
+    env.registerNatives(classQoreFunctionRef, qoreFunctionRefNativeMethods,
+        sizeof(qoreFunctionRefNativeMethods) / sizeof(JNINativeMethod));
+
+    classQoreFutureListener = findDefineClass(env, "org.qore.jni.QoreFutureListener", nullptr,
+        java_org_qore_jni_QoreFutureListener_class, java_org_qore_jni_QoreFutureListener_class_len).makeGlobal();
+    env.registerNatives(classQoreFutureListener, qoreFutureListenerNativeMethods,
+        sizeof(qoreFutureListenerNativeMethods) / sizeof(JNINativeMethod));
+    methodQoreFutureListenerListen = env.getStaticMethod(classQoreFutureListener, "listen",
+        "(Ljava/util/concurrent/CompletionStage;J)V");
+
+    classCompletionStage = env.findClass("java/util/concurrent/CompletionStage").makeGlobal();
+
     classQoreObjectWrapper = findDefineClass(env, "org.qore.jni.QoreObjectWrapper", nullptr,
         java_org_qore_jni_QoreObjectWrapper_class, java_org_qore_jni_QoreObjectWrapper_class_len).makeGlobal();
 
@@ -2633,18 +3229,52 @@ bool Globals::init() {
     methodConstructorNewInstance = env.getMethod(classConstructor, "newInstance",
         "([Ljava/lang/Object;)Ljava/lang/Object;");
 
+    // helper classes for asynchronous dispatching
+    findDefineClass(env, "org.qore.jni.QoreAsyncCall", nullptr, java_org_qore_jni_QoreAsyncCall_class,
+        java_org_qore_jni_QoreAsyncCall_class_len);
+    findDefineClass(env, "org.qore.jni.QoreAsyncPool", nullptr, java_org_qore_jni_QoreAsyncPool_class,
+        java_org_qore_jni_QoreAsyncPool_class_len);
+    findDefineClass(env, "org.qore.jni.QoreAsyncWorker", nullptr, java_org_qore_jni_QoreAsyncWorker_class,
+        java_org_qore_jni_QoreAsyncWorker_class_len);
+
     classQoreInvocationHandler = findDefineClass(env, "org.qore.jni.QoreInvocationHandler", nullptr,
         java_org_qore_jni_QoreInvocationHandler_class, java_org_qore_jni_QoreInvocationHandler_class_len).makeGlobal();
-    env.registerNatives(classQoreInvocationHandler, invocationHandlerNativeMethods, 2);
+    env.registerNatives(classQoreInvocationHandler, invocationHandlerNativeMethods,
+        sizeof(invocationHandlerNativeMethods) / sizeof(JNINativeMethod));
     ctorQoreInvocationHandler = env.getMethod(classQoreInvocationHandler, "<init>", "(J)V");
     methodQoreInvocationHandlerDestroy = env.getMethod(classQoreInvocationHandler, "destroy", "()V");
+    methodQoreInvocationHandlerStartAsync = env.getMethod(classQoreInvocationHandler, "startAsync", "(IIIZZ)V");
+
+    // the parallel map worker threads attach themselves with QoreInvocationHandler.attach0()
+    findDefineClass(env, "org.qore.jni.QoreParallelMapJob", nullptr, java_org_qore_jni_QoreParallelMapJob_class,
+        java_org_qore_jni_QoreParallelMapJob_class_len);
+    findDefineClass(env, "org.qore.jni.QoreParallelMapThread", nullptr,
+        java_org_qore_jni_QoreParallelMapThread_class, java_org_qore_jni_QoreParallelMapThread_class_len);
+    classQoreParallelMap = findDefineClass(env, "org.qore.jni.QoreParallelMap", nullptr,
+        java_org_qore_jni_QoreParallelMap_class, java_org_qore_jni_QoreParallelMap_class_len).makeGlobal();
+    env.registerNatives(classQoreParallelMap, qoreParallelMapNativeMethods,
+        sizeof(qoreParallelMapNativeMethods) / sizeof(JNINativeMethod));
+    methodQoreParallelMapMap = env.getStaticMethod(classQoreParallelMap, "map", "(JLjava/lang/Object;IJ)J");
 
     classQoreJavaApi = findDefineClass(env, "org.qore.jni.QoreJavaApi", nullptr, java_org_qore_jni_QoreJavaApi_class,
         java_org_qore_jni_QoreJavaApi_class_len).makeGlobal();
+    findDefineClass(env, "org.qore.jni.QoreJavaApi$1", nullptr, java_org_qore_jni_QoreJavaApi_1_class,
+        java_org_qore_jni_QoreJavaApi_1_class_len);
     env.registerNatives(classQoreJavaApi, qoreJavaApiNativeMethods,
         sizeof(qoreJavaApiNativeMethods) / sizeof(JNINativeMethod));
-    methodQoreJavaApiGetStackTrace = env.getStaticMethod(classQoreJavaApi, "getStackTrace",
-        "()[Ljava/lang/StackTraceElement;");
+    methodQoreJavaApiGetStackFrames = env.getStaticMethod(classQoreJavaApi, "getStackFrames",
+        "(II)[Ljava/lang/Object;");
+    methodQoreJavaApiSetStackTraceDepth = env.getStaticMethod(classQoreJavaApi, "setStackTraceDepth", "(I)V");
+    methodQoreJavaApiSetStackTraceFilter = env.getStaticMethod(classQoreJavaApi, "setStackTraceFilter",
+        "([Ljava/lang/String;)V");
+    methodQoreJavaApiSetExceptionStackDepth = env.getStaticMethod(classQoreJavaApi, "setExceptionStackDepth",
+        "(I)V");
+    methodQoreJavaApiGetThrowableDescription = env.getStaticMethod(classQoreJavaApi, "getThrowableDescription",
+        "(Ljava/lang/Throwable;Z)Ljava/lang/String;");
+    methodQoreJavaApiGetThrowableInfo = env.getStaticMethod(classQoreJavaApi, "getThrowableInfo",
+        "(Ljava/lang/Throwable;)[Ljava/lang/Object;");
+    methodQoreJavaApiGetFunctionalMethod = env.getStaticMethod(classQoreJavaApi, "getFunctionalMethod",
+        "(Ljava/lang/Class;)Ljava/lang/reflect/Method;");
 
     classProxy = env.findClass("java/lang/reflect/Proxy").makeGlobal();
     methodProxyNewProxyInstance = env.getStaticMethod(classProxy, "newProxyInstance",
@@ -2811,6 +3441,8 @@ bool Globals::init() {
 
     classPreparedStatement = env.findClass("java/sql/PreparedStatement").makeGlobal();
     methodPreparedStatementAddBatch = env.getMethod(classPreparedStatement, "addBatch", "()V");
+    methodPreparedStatementClearBatch = env.getMethod(classPreparedStatement, "clearBatch", "()V");
+    methodPreparedStatementClearParameters = env.getMethod(classPreparedStatement, "clearParameters", "()V");
     methodPreparedStatementClose = env.getMethod(classPreparedStatement, "close", "()V");
     methodPreparedStatementExecute = env.getMethod(classPreparedStatement, "execute", "()Z");
     methodPreparedStatementExecuteBatch = env.getMethod(classPreparedStatement, "executeBatch", "()[I");
@@ -2821,10 +3453,15 @@ bool Globals::init() {
     methodPreparedStatementSetArray = env.getMethod(classPreparedStatement, "setArray", "(ILjava/sql/Array;)V");
     methodPreparedStatementSetBigDecimal = env.getMethod(classPreparedStatement, "setBigDecimal",
         "(ILjava/math/BigDecimal;)V");
+    methodPreparedStatementSetBinaryStream = env.getMethod(classPreparedStatement, "setBinaryStream",
+        "(ILjava/io/InputStream;)V");
+    methodPreparedStatementSetBinaryStreamLength = env.getMethod(classPreparedStatement, "setBinaryStream",
+        "(ILjava/io/InputStream;J)V");
     methodPreparedStatementSetBoolean = env.getMethod(classPreparedStatement, "setBoolean", "(IZ)V");
     methodPreparedStatementSetByte = env.getMethod(classPreparedStatement, "setByte", "(IB)V");
     methodPreparedStatementSetBytes = env.getMethod(classPreparedStatement, "setBytes", "(I[B)V");
     methodPreparedStatementSetDouble = env.getMethod(classPreparedStatement, "setDouble", "(ID)V");
+    methodPreparedStatementSetFetchSize = env.getMethod(classPreparedStatement, "setFetchSize", "(I)V");
     methodPreparedStatementSetInt = env.getMethod(classPreparedStatement, "setInt", "(II)V");
     methodPreparedStatementSetLong = env.getMethod(classPreparedStatement, "setLong", "(IJ)V");
     methodPreparedStatementSetShort = env.getMethod(classPreparedStatement, "setShort", "(IS)V");
@@ -2850,6 +3487,13 @@ bool Globals::init() {
     methodResultSetGetMetaData = env.getMethod(classResultSet, "getMetaData", "()Ljava/sql/ResultSetMetaData;");
     methodResultSetGetArray = env.getMethod(classResultSet, "getArray", "(I)Ljava/sql/Array;");
     methodResultSetGetObject = env.getMethod(classResultSet, "getObject", "(I)Ljava/lang/Object;");
+    methodResultSetGetBoolean = env.getMethod(classResultSet, "getBoolean", "(I)Z");
+    methodResultSetGetBytes = env.getMethod(classResultSet, "getBytes", "(I)[B");
+    methodResultSetGetDouble = env.getMethod(classResultSet, "getDouble", "(I)D");
+    methodResultSetGetLong = env.getMethod(classResultSet, "getLong", "(I)J");
+    methodResultSetGetString = env.getMethod(classResultSet, "getString", "(I)Ljava/lang/String;");
+    methodResultSetGetTimestamp = env.getMethod(classResultSet, "getTimestamp", "(I)Ljava/sql/Timestamp;");
+    methodResultSetWasNull = env.getMethod(classResultSet, "wasNull", "()Z");
 
     classResultSetMetaData = env.findClass("java/sql/ResultSetMetaData").makeGlobal();
     methodResultSetMetaDataGetColumnClassName = env.getMethod(classResultSetMetaData, "getColumnClassName",
@@ -2859,11 +3503,15 @@ bool Globals::init() {
         "(I)Ljava/lang/String;");
     methodResultSetMetaDataGetColumnType = env.getMethod(classResultSetMetaData, "getColumnType",
         "(I)I");
+    methodResultSetMetaDataIsSigned = env.getMethod(classResultSetMetaData, "isSigned", "(I)Z");
 
     classArray = env.findClass("java/sql/Array").makeGlobal();
     methodArrayGetArray = env.getMethod(classArray, "getArray", "()Ljava/lang/Object;");
 
     classSQLException = env.findClass("java/sql/SQLException").makeGlobal();
+    methodSQLExceptionGetSQLState = env.getMethod(classSQLException, "getSQLState", "()Ljava/lang/String;");
+
+    classInputStream = env.findClass("java/io/InputStream").makeGlobal();
 
     classServiceLoader = env.findClass("java/util/ServiceLoader").makeGlobal();
     methodServiceLoaderIterator = env.getMethod(classServiceLoader, "iterator",
@@ -2871,12 +3519,100 @@ bool Globals::init() {
 
     classDriver = env.findClass("java/sql/Driver").makeGlobal();
 
+    classJdbcBlockFetcher = findDefineClass(env, "org.qore.jni.JdbcBlockFetcher", nullptr,
+        java_org_qore_jni_JdbcBlockFetcher_class, java_org_qore_jni_JdbcBlockFetcher_class_len).makeGlobal();
+    ctorJdbcBlockFetcher = env.getMethod(classJdbcBlockFetcher, "<init>", "(Ljava/sql/ResultSet;[II)V");
+    methodJdbcBlockFetcherFetch = env.getMethod(classJdbcBlockFetcher, "fetch", "(I)I");
+    methodJdbcBlockFetcherGetNulls = env.getMethod(classJdbcBlockFetcher, "getNulls", "(I)[Z");
+    methodJdbcBlockFetcherGetLongs = env.getMethod(classJdbcBlockFetcher, "getLongs", "(I)[J");
+    methodJdbcBlockFetcherGetDoubles = env.getMethod(classJdbcBlockFetcher, "getDoubles", "(I)[D");
+    methodJdbcBlockFetcherGetObjects = env.getMethod(classJdbcBlockFetcher, "getObjects", "(I)[Ljava/lang/Object;");
+    methodJdbcBlockFetcherGetRowCount = env.getMethod(classJdbcBlockFetcher, "getRowCount", "()I");
+    methodJdbcBlockFetcherGetColumnTypes = env.getStaticMethod(classJdbcBlockFetcher, "getColumnTypes",
+        "(Ljava/sql/ResultSet;)[I");
+
+    classJdbcRowPrefetcher = findDefineClass(env, "org.qore.jni.JdbcRowPrefetcher", nullptr,
+        java_org_qore_jni_JdbcRowPrefetcher_class, java_org_qore_jni_JdbcRowPrefetcher_class_len).makeGlobal();
+    ctorJdbcRowPrefetcher = env.getMethod(classJdbcRowPrefetcher, "<init>", "(Ljava/sql/ResultSet;[III)V");
+    methodJdbcRowPrefetcherTake = env.getMethod(classJdbcRowPrefetcher, "take", "()Lorg/qore/jni/JdbcBlockFetcher;");
+    methodJdbcRowPrefetcherStop = env.getMethod(classJdbcRowPrefetcher, "stop", "()V");
+    methodJdbcRowPrefetcherClose = env.getMethod(classJdbcRowPrefetcher, "close", "()V");
+
+    classJdbcKeepalive = findDefineClass(env, "org.qore.jni.JdbcKeepalive", nullptr,
+        java_org_qore_jni_JdbcKeepalive_class, java_org_qore_jni_JdbcKeepalive_class_len).makeGlobal();
+    env.registerNatives(classJdbcKeepalive, jdbcKeepaliveNativeMethods,
+        sizeof(jdbcKeepaliveNativeMethods) / sizeof(JNINativeMethod));
+    ctorJdbcKeepalive = env.getMethod(classJdbcKeepalive, "<init>", "(Ljava/sql/Connection;IJ)V");
+    methodJdbcKeepaliveSetBusy = env.getMethod(classJdbcKeepalive, "setBusy", "(Z)V");
+    methodJdbcKeepaliveClose = env.getMethod(classJdbcKeepalive, "close", "()V");
+
+    classJdbcLobStream = findDefineClass(env, "org.qore.jni.JdbcLobStream", nullptr,
+        java_org_qore_jni_JdbcLobStream_class, java_org_qore_jni_JdbcLobStream_class_len).makeGlobal();
+    methodJdbcLobStreamGet = env.getStaticMethod(classJdbcLobStream, "get",
+        "(Ljava/sql/ResultSet;IZI)Lorg/qore/jni/JdbcLobStream;");
+
+    classJdbcBindStream = findDefineClass(env, "org.qore.jni.JdbcBindStream", nullptr,
+        java_org_qore_jni_JdbcBindStream_class, java_org_qore_jni_JdbcBindStream_class_len).makeGlobal();
+    ctorJdbcBindStreamBuffer = env.getMethod(classJdbcBindStream, "<init>", "(Ljava/nio/ByteBuffer;)V");
+    ctorJdbcBindStreamObject = env.getMethod(classJdbcBindStream, "<init>", "(Lorg/qore/jni/QoreObject;)V");
+    methodJdbcBindStreamDetach = env.getMethod(classJdbcBindStream, "detach", "()V");
+
+    classJdbcBatchBinder = findDefineClass(env, "org.qore.jni.JdbcBatchBinder", nullptr,
+        java_org_qore_jni_JdbcBatchBinder_class, java_org_qore_jni_JdbcBatchBinder_class_len).makeGlobal();
+    ctorJdbcBatchBinder = env.getMethod(classJdbcBatchBinder, "<init>",
+        "([I[Ljava/lang/Object;[Ljava/lang/Object;)V");
+    methodJdbcBatchBinderBind = env.getMethod(classJdbcBatchBinder, "bind", "(Ljava/sql/PreparedStatement;II)V");
+    methodJdbcBatchBinderToArray = env.getStaticMethod(classJdbcBatchBinder, "toArray",
+        "(ILjava/lang/Object;[Z)[Ljava/lang/Object;");
+
     {
         LocalReference<jclass> classTypes = env.findClass("java/sql/Types");
         jfieldID field = env.getStaticField(classTypes, "NULL", "I");
         typeNull = env.getStaticIntField(classTypes, field);
         field = env.getStaticField(classTypes, "CHAR", "I");
         typeChar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "TINYINT", "I");
+        typeTinyInt = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "SMALLINT", "I");
+        typeSmallInt = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "INTEGER", "I");
+        typeInteger = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "BIGINT", "I");
+        typeBigInt = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "REAL", "I");
+        typeReal = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "FLOAT", "I");
+        typeFloat = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "DOUBLE", "I");
+        typeDouble = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "BOOLEAN", "I");
+        typeBoolean = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "VARCHAR", "I");
+        typeVarchar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "LONGVARCHAR", "I");
+        typeLongVarchar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "NCHAR", "I");
+        typeNChar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "NVARCHAR", "I");
+        typeNVarchar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "LONGNVARCHAR", "I");
+        typeLongNVarchar = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "BINARY", "I");
+        typeBinary = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "VARBINARY", "I");
+        typeVarBinary = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "LONGVARBINARY", "I");
+        typeLongVarBinary = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "TIMESTAMP", "I");
+        typeTimestamp = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "ARRAY", "I");
+        typeArray = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "BLOB", "I");
+        typeBlob = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "CLOB", "I");
+        typeClob = env.getStaticIntField(classTypes, field);
+        field = env.getStaticField(classTypes, "NCLOB", "I");
+        typeNClob = env.getStaticIntField(classTypes, field);
     }
 
     assert(!classQoreURLClassLoader);
@@ -2906,19 +3642,31 @@ bool Globals::init() {
 
     if (!bootstrap) {
         printd(5, "Globals::init() creating syscl\n");
-        jmethodID ctorQoreURLClassLoaderSys = env.getMethod(classQoreURLClassLoader, "<init>", "(J)V");
         jvalue jarg;
         jarg.j = (jlong)Globals::createJavaContextProgram();
         printd(5, "Global syscl pgm: %p\n", jarg.j);
-        syscl = env.newObject(classQoreURLClassLoader, ctorQoreURLClassLoaderSys, &jarg).makeGlobal();
+        if (classes_from_jar) {
+            // module classes are loaded by the application class loader, which must therefore be the parent, or
+            // the class loader would define its own copies of them
+            jmethodID methodClassLoaderGetSystemClassLoader = env.getStaticMethod(classClassLoader,
+                "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+            LocalReference<jobject> app_loader = env.callStaticObjectMethod(classClassLoader,
+                methodClassLoaderGetSystemClassLoader, nullptr);
+            std::vector<jvalue> jargs(2);
+            jargs[0].j = jarg.j;
+            jargs[1].l = app_loader;
+            syscl = env.newObject(classQoreURLClassLoader, ctorQoreURLClassLoader, &jargs[0]).makeGlobal();
+        } else {
+            jmethodID ctorQoreURLClassLoaderSys = env.getMethod(classQoreURLClassLoader, "<init>", "(J)V");
+            syscl = env.newObject(classQoreURLClassLoader, ctorQoreURLClassLoaderSys, &jarg).makeGlobal();
+        }
 
         {
             std::vector<jvalue> jargs(2);
             LocalReference<jbyteArray> jbyte_code =
                 env.newByteArray(java_org_qore_jni_JavaClassBuilder_1_class_len).as<jbyteArray>();
-            for (jsize i = 0; i < static_cast<jsize>(java_org_qore_jni_JavaClassBuilder_1_class_len); ++i) {
-                env.setByteArrayElement(jbyte_code, i, ((const char*)java_org_qore_jni_JavaClassBuilder_1_class)[i]);
-            }
+            env.setByteArrayRegion(jbyte_code, 0, java_org_qore_jni_JavaClassBuilder_1_class_len,
+                java_org_qore_jni_JavaClassBuilder_1_class);
             LocalReference<jstring> bname = env.newString("org.qore.jni.JavaClassBuilder$1");
             jargs[0].l = bname;
             jargs[1].l = jbyte_code;
@@ -2930,9 +3678,8 @@ bool Globals::init() {
             std::vector<jvalue> jargs(2);
             LocalReference<jbyteArray> jbyte_code =
                 env.newByteArray(java_org_qore_jni_JavaClassBuilder_class_len).as<jbyteArray>();
-            for (jsize i = 0; i < static_cast<jsize>(java_org_qore_jni_JavaClassBuilder_class_len); ++i) {
-                env.setByteArrayElement(jbyte_code, i, ((const char*)java_org_qore_jni_JavaClassBuilder_class)[i]);
-            }
+            env.setByteArrayRegion(jbyte_code, 0, java_org_qore_jni_JavaClassBuilder_class_len,
+                java_org_qore_jni_JavaClassBuilder_class);
             LocalReference<jstring> bname = env.newString("org.qore.jni.JavaClassBuilder");
             jargs[0].l = bname;
             jargs[1].l = jbyte_code;
@@ -3031,6 +3778,12 @@ void Globals::cleanup() {
     classQoreJavaObjectPtr = nullptr;
     classQoreObject = nullptr;
     classQoreClosure = nullptr;
+    classQoreTask = nullptr;
+    classQoreMethodRef = nullptr;
+    classQoreFunctionRef = nullptr;
+    classQoreFutureListener = nullptr;
+    classQoreParallelMap = nullptr;
+    classCompletionStage = nullptr;
     classQoreObjectWrapper = nullptr;
     classQoreClosureMarker = nullptr;
     classQoreClosureMarkerImpl = nullptr;
@@ -3075,8 +3828,15 @@ void Globals::cleanup() {
     classResultSetMetaData = nullptr;
     classArray = nullptr;
     classSQLException = nullptr;
+    classInputStream = nullptr;
     classServiceLoader = nullptr;
     classDriver = nullptr;
+    classJdbcBlockFetcher = nullptr;
+    classJdbcRowPrefetcher = nullptr;
+    classJdbcKeepalive = nullptr;
+    classJdbcLobStream = nullptr;
+    classJdbcBindStream = nullptr;
+    classJdbcBatchBinder = nullptr;
     javaQoreClassField = nullptr;
 }
 
@@ -3218,6 +3978,13 @@ const QoreStackLocation* QoreJniStackLocationHelper::getNext() const {
     if ((unsigned)current < size()) {
         return this;
     }
+    // get the next frames only when the caller iterates past the frames already retrieved
+    if (!complete) {
+        fetch(size());
+        if ((unsigned)current < size()) {
+            return this;
+        }
+    }
     current = 0;
     return stack_next;
 }
@@ -3229,48 +3996,63 @@ void QoreJniStackLocationHelper::checkInit() const {
     }
     init = true;
 
+    fetch(JNI_STACK_INITIAL_FRAMES);
+
+    if (!size()) {
+        stack_call.push_back(jni_no_call_name);
+        stack_native.push_back(true);
+        stack_loc.push_back(jni_loc_builtin);
+    }
+}
+
+void QoreJniStackLocationHelper::fetch(jsize count) const {
+    assert(!complete);
+    // the frames are returned as parallel arrays, so the walk costs one JNI call per chunk instead of several
+    // per frame
+    complete = true;
     Env env;
 
     try {
-        LocalReference<jobjectArray> jstack = env.callStaticObjectMethod(Globals::classQoreJavaApi,
-            Globals::methodQoreJavaApiGetStackTrace, nullptr).as<jobjectArray>();
-
-        if (jstack) {
-            jsize len = env.getArrayLength(jstack);
-            stack_loc.reserve(len);
-            stack_native.reserve(len);
-            stack_call.reserve(len);
-            for (jsize i = 0; i < len; ++i) {
-                LocalReference<jobject> jste = env.getObjectArrayElement(jstack, i);
-
-                LocalReference<jstring> jcls = env.callObjectMethod(jste, Globals::methodStackTraceElementGetClassName, nullptr).as<jstring>();
-                jni::Env::GetStringUtfChars cname(env, jcls);
-                LocalReference<jstring> jmethod = env.callObjectMethod(jste, Globals::methodStackTraceElementGetMethodName, nullptr).as<jstring>();
-                jni::Env::GetStringUtfChars mname(env, jmethod);
-                LocalReference<jstring> jfilename = env.callObjectMethod(jste, Globals::methodStackTraceElementGetFileName, nullptr).as<jstring>();
-                jni::Env::GetStringUtfChars file(env, jfilename);
-                jint line = env.callIntMethod(jste, Globals::methodStackTraceElementGetLineNumber, nullptr);
-                jboolean native = env.callBooleanMethod(jste, Globals::methodStackTraceElementIsNativeMethod, nullptr);
-
-                QoreStringMaker code("%s.%s", cname.c_str(), mname.c_str());
-
-                QoreExternalProgramLocationWrapper loc(file.c_str(), line, line, nullptr, 0, "Java");
-                //printd(5, "QoreJniStackLocationHelper::checkInit() %d/%d %s:%d %s::%s()\n", (int)i, (int)len,
-                //    file.c_str(), line, cname.c_str(), mname.c_str());
-                stack_loc.push_back(loc);
-                stack_call.push_back(code.c_str());
-                stack_native.push_back(native);
-            }
+        jvalue jargs[2];
+        jargs[0].i = size();
+        jargs[1].i = count;
+        LocalReference<jobjectArray> jframes = env.callStaticObjectMethod(Globals::classQoreJavaApi,
+            Globals::methodQoreJavaApiGetStackFrames, &jargs[0]).as<jobjectArray>();
+        if (!jframes) {
+            return;
         }
+
+        LocalReference<jobjectArray> jcalls = env.getObjectArrayElement(jframes, 0).as<jobjectArray>();
+        LocalReference<jobjectArray> jfiles = env.getObjectArrayElement(jframes, 1).as<jobjectArray>();
+        LocalReference<jintArray> jlines = env.getObjectArrayElement(jframes, 2).as<jintArray>();
+
+        jsize len = env.getArrayLength(jcalls);
+        std::vector<jint> lines(len);
+        env.getIntArrayRegion(jlines, 0, len, lines.data());
+
+        stack_loc.reserve(stack_loc.size() + len);
+        stack_native.reserve(stack_native.size() + len);
+        stack_call.reserve(stack_call.size() + len);
+        for (jsize i = 0; i < len; ++i) {
+            LocalReference<jstring> jcall = env.getObjectArrayElement(jcalls, i).as<jstring>();
+            jni::Env::GetStringUtfChars call(env, jcall);
+            LocalReference<jstring> jfile = env.getObjectArrayElement(jfiles, i).as<jstring>();
+            jni::Env::GetStringUtfChars file(env, jfile);
+            // Java reports -2 as the line number of native methods
+            jint line = lines[i];
+            bool native = line == -2;
+
+            //printd(5, "QoreJniStackLocationHelper::fetch() %d/%d %s:%d %s()\n", (int)i, (int)len, file.c_str(),
+            //    line, call.c_str());
+            stack_loc.push_back(QoreExternalProgramLocationWrapper(file.c_str(), line, line, nullptr, 0, "Java"));
+            stack_call.push_back(call.c_str());
+            stack_native.push_back(native);
+        }
+        // there are no more frames if fewer were returned than requested
+        complete = len < count;
     } catch (jni::Exception& e) {
         e.ignore();
     }
-
-    if (!size()) {
-        stack_call.push_back(jni_no_call_name);
-        stack_native.push_back(true);
-        stack_loc.push_back(jni_loc_builtin);
-    }
 }
 
 } // namespace jni
@@ -34,6 +34,8 @@
 #include "GlobalReference.h"
 #include "Env.h"
 
+#include <atomic>
+
 DLLLOCAL QoreStringNode* jni_module_init_intern();
 
 #define QORE_JNI_MODULE_NAME "jni"
@@ -47,7 +49,8 @@ enum class Type {
 };
 
 DLLLOCAL extern bool jni_qore_init;
-DLLLOCAL extern bool jni_qore_init_done;
+//! set when the class map has been initialized; can be set by the background initialization thread
+DLLLOCAL extern std::atomic<bool> jni_qore_init_done;
 
 DLLLOCAL const std::string JniImportedFunctionClassName = "$Functions";
 DLLLOCAL const std::string JniImportedConstantClassName = "$Constants";
@@ -144,9 +147,16 @@ public:
     DLLLOCAL static GlobalReference<jclass> classQoreInvocationHandler;           // org.qore.jni.QoreInvocationHandler
     DLLLOCAL static jmethodID ctorQoreInvocationHandler;                          // QoreInvocationHandler(long)
     DLLLOCAL static jmethodID methodQoreInvocationHandlerDestroy;                 // void QoreInvocationHandler.destroy()
+    DLLLOCAL static jmethodID methodQoreInvocationHandlerStartAsync;              // void QoreInvocationHandler.startAsync(int, int, int, boolean, boolean)
 
     DLLLOCAL static GlobalReference<jclass> classQoreJavaApi;                     // org.qore.jni.QoreJavaApi
-    DLLLOCAL static jmethodID methodQoreJavaApiGetStackTrace;                     // StackTraceElement[] getStackTrace()
+    DLLLOCAL static jmethodID methodQoreJavaApiGetStackFrames;                    // Object[] getStackFrames(int, int)
+    DLLLOCAL static jmethodID methodQoreJavaApiSetStackTraceDepth;                // void setStackTraceDepth(int)
+    DLLLOCAL static jmethodID methodQoreJavaApiSetStackTraceFilter;               // void setStackTraceFilter(String...)
+    DLLLOCAL static jmethodID methodQoreJavaApiSetExceptionStackDepth;            // void setExceptionStackDepth(int)
+    DLLLOCAL static jmethodID methodQoreJavaApiGetThrowableDescription;           // String getThrowableDescription(Throwable, boolean)
+    DLLLOCAL static jmethodID methodQoreJavaApiGetThrowableInfo;                  // Object[] getThrowableInfo(Throwable)
+    DLLLOCAL static jmethodID methodQoreJavaApiGetFunctionalMethod;               // Method getFunctionalMethod(Class<?>)
 
     DLLLOCAL static GlobalReference<jclass> classQoreExceptionWrapper;            // org.qore.jni.QoreExceptionWrapper
     DLLLOCAL static jmethodID ctorQoreExceptionWrapper;                           // QoreExceptionWrapper(long)
@@ -168,10 +178,54 @@ public:
     DLLLOCAL static GlobalReference<jclass> classQoreJavaObjectPtr;               // org.qore.jni.QoreJavaObjectPtr
     DLLLOCAL static jmethodID ctorQoreJavaObjectPtr;                              // QoreJavaObjectPtr(long)
 
+    DLLLOCAL static GlobalReference<jclass> classJdbcBlockFetcher;                // org.qore.jni.JdbcBlockFetcher
+    DLLLOCAL static jmethodID ctorJdbcBlockFetcher;                               // JdbcBlockFetcher(ResultSet, int[], int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherFetch;                        // int fetch(int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetNulls;                     // boolean[] getNulls(int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetLongs;                     // long[] getLongs(int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetDoubles;                   // double[] getDoubles(int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetObjects;                   // Object[] getObjects(int)
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetRowCount;                  // int getRowCount()
+    DLLLOCAL static jmethodID methodJdbcBlockFetcherGetColumnTypes;               // static int[] getColumnTypes(ResultSet)
+    DLLLOCAL static GlobalReference<jclass> classJdbcRowPrefetcher;               // org.qore.jni.JdbcRowPrefetcher
+    DLLLOCAL static jmethodID ctorJdbcRowPrefetcher;                              // JdbcRowPrefetcher(ResultSet, int[], int, int)
+    DLLLOCAL static jmethodID methodJdbcRowPrefetcherTake;                        // JdbcBlockFetcher take()
+    DLLLOCAL static jmethodID methodJdbcRowPrefetcherStop;                        // void stop()
+    DLLLOCAL static jmethodID methodJdbcRowPrefetcherClose;                       // void close()
+    DLLLOCAL static GlobalReference<jclass> classJdbcKeepalive;                   // org.qore.jni.JdbcKeepalive
+    DLLLOCAL static jmethodID ctorJdbcKeepalive;                                  // JdbcKeepalive(Connection, int, long)
+    DLLLOCAL static jmethodID methodJdbcKeepaliveSetBusy;                         // void setBusy(boolean)
+    DLLLOCAL static jmethodID methodJdbcKeepaliveClose;                           // void close()
+    DLLLOCAL static GlobalReference<jclass> classJdbcLobStream;                   // org.qore.jni.JdbcLobStream
+    DLLLOCAL static jmethodID methodJdbcLobStreamGet;                             // static JdbcLobStream get(ResultSet, int, boolean, int)
+    DLLLOCAL static GlobalReference<jclass> classJdbcBindStream;                  // org.qore.jni.JdbcBindStream
+    DLLLOCAL static jmethodID ctorJdbcBindStreamBuffer;                           // JdbcBindStream(ByteBuffer)
+    DLLLOCAL static jmethodID ctorJdbcBindStreamObject;                           // JdbcBindStream(QoreObject)
+    DLLLOCAL static jmethodID methodJdbcBindStreamDetach;                         // void detach()
+
+    DLLLOCAL static GlobalReference<jclass> classJdbcBatchBinder;                 // org.qore.jni.JdbcBatchBinder
+    DLLLOCAL static jmethodID ctorJdbcBatchBinder;                                // JdbcBatchBinder(int[], Object[], Object[])
+    DLLLOCAL static jmethodID methodJdbcBatchBinderBind;                          // void bind(PreparedStatement, int, int)
+    DLLLOCAL static jmethodID methodJdbcBatchBinderToArray;                       // static Object[] toArray(int, Object, boolean[])
+
     DLLLOCAL static GlobalReference<jclass> classQoreClosure;                     // org.qore.jni.QoreClosure
     DLLLOCAL static jmethodID ctorQoreClosure;                                    // QoreClosure(long)
     DLLLOCAL static jmethodID methodQoreClosureGet;                               // long QoreClosure.get()
 
+    DLLLOCAL static GlobalReference<jclass> classQoreTask;                        // org.qore.jni.QoreTask
+    DLLLOCAL static jmethodID ctorQoreTask;                                       // QoreTask(long, QoreClosure)
+
+    DLLLOCAL static GlobalReference<jclass> classQoreMethodRef;                   // org.qore.jni.QoreMethodRef
+    DLLLOCAL static GlobalReference<jclass> classQoreFunctionRef;                 // org.qore.jni.QoreFunctionRef
+
+    DLLLOCAL static GlobalReference<jclass> classQoreFutureListener;              // org.qore.jni.QoreFutureListener
+    DLLLOCAL static jmethodID methodQoreFutureListenerListen;                     // static void QoreFutureListener.listen(CompletionStage, long)
+
+    DLLLOCAL static GlobalReference<jclass> classQoreParallelMap;                 // org.qore.jni.QoreParallelMap
+    DLLLOCAL static jmethodID methodQoreParallelMapMap;                           // static long QoreParallelMap.map(long, Object, int, long)
+
+    DLLLOCAL static GlobalReference<jclass> classCompletionStage;                 // java.util.concurrent.CompletionStage
+
     DLLLOCAL static GlobalReference<jclass> classQoreObjectWrapper;               // org.qore.jni.QoreObjectWrapper
 
     DLLLOCAL static GlobalReference<jclass> classQoreClosureMarker;               // org.qore.jni.QoreClosureMarker
@@ -345,6 +399,8 @@ public:
 
     DLLLOCAL static GlobalReference<jclass> classPreparedStatement;               // java.sql.PreparedStatement
     DLLLOCAL static jmethodID methodPreparedStatementAddBatch;                    // void addBatch()
+    DLLLOCAL static jmethodID methodPreparedStatementClearBatch;                  // void clearBatch()
+    DLLLOCAL static jmethodID methodPreparedStatementClearParameters;             // void clearParameters()
     DLLLOCAL static jmethodID methodPreparedStatementClose;                       // void close()
     DLLLOCAL static jmethodID methodPreparedStatementExecute;                     // boolean execute()
     DLLLOCAL static jmethodID methodPreparedStatementExecuteBatch;                // int[] executeBatch()
@@ -353,10 +409,13 @@ public:
     DLLLOCAL static jmethodID methodPreparedStatementGetUpdateCount;              // int getUpdateCount()
     DLLLOCAL static jmethodID methodPreparedStatementSetArray;                    // void setArray(int, Array)
     DLLLOCAL static jmethodID methodPreparedStatementSetBigDecimal;               // void setBigDecimal(int, BigDecimal)
+    DLLLOCAL static jmethodID methodPreparedStatementSetBinaryStream;             // void setBinaryStream(int, InputStream)
+    DLLLOCAL static jmethodID methodPreparedStatementSetBinaryStreamLength;       // void setBinaryStream(int, InputStream, long)
     DLLLOCAL static jmethodID methodPreparedStatementSetBoolean;                  // void setBoolean(int, boolean)
     DLLLOCAL static jmethodID methodPreparedStatementSetByte;                     // void setByte(int, byte)
     DLLLOCAL static jmethodID methodPreparedStatementSetBytes;                    // void setBytes(int, byte[])
     DLLLOCAL static jmethodID methodPreparedStatementSetDouble;                   // void setBoolean(int, double)
+    DLLLOCAL static jmethodID methodPreparedStatementSetFetchSize;                // void setFetchSize(int)
     DLLLOCAL static jmethodID methodPreparedStatementSetInt;                      // void setInt(int, int)
     DLLLOCAL static jmethodID methodPreparedStatementSetLong;                     // void setLong(int, long)
     DLLLOCAL static jmethodID methodPreparedStatementSetShort;                    // void setShort(int, short)
@@ -381,17 +440,28 @@ public:
     DLLLOCAL static jmethodID methodResultSetGetObject;                           // Object getObject(int)
     DLLLOCAL static jmethodID methodResultSetNext;                                // boolean next()
     DLLLOCAL static jmethodID methodResultSetGetMetaData;                         // ResultSetMetaData getMetaData()
+    DLLLOCAL static jmethodID methodResultSetGetBoolean;                          // boolean getBoolean(int)
+    DLLLOCAL static jmethodID methodResultSetGetBytes;                            // byte[] getBytes(int)
+    DLLLOCAL static jmethodID methodResultSetGetDouble;                           // double getDouble(int)
+    DLLLOCAL static jmethodID methodResultSetGetLong;                             // long getLong(int)
+    DLLLOCAL static jmethodID methodResultSetGetString;                           // String getString(int)
+    DLLLOCAL static jmethodID methodResultSetGetTimestamp;                        // Timestamp getTimestamp(int)
+    DLLLOCAL static jmethodID methodResultSetWasNull;                             // boolean wasNull()
 
     DLLLOCAL static GlobalReference<jclass> classResultSetMetaData;               // java.sql.ResultSetMetadata
     DLLLOCAL static jmethodID methodResultSetMetaDataGetColumnClassName;          // String getColumnClassName()
     DLLLOCAL static jmethodID methodResultSetMetaDataGetColumnCount;              // int getColumnCount()
     DLLLOCAL static jmethodID methodResultSetMetaDataGetColumnLabel;              // String getColumnLabel(int)
     DLLLOCAL static jmethodID methodResultSetMetaDataGetColumnType;               // int getColumnType(int)
+    DLLLOCAL static jmethodID methodResultSetMetaDataIsSigned;                    // boolean isSigned(int)
 
     DLLLOCAL static GlobalReference<jclass> classArray;                           // java.sql.Array
     DLLLOCAL static jmethodID methodArrayGetArray;                                // Object getArray()
 
     DLLLOCAL static GlobalReference<jclass> classSQLException;                    // java.sql.SQLException
+    DLLLOCAL static jmethodID methodSQLExceptionGetSQLState;                      // String getSQLState()
+
+    DLLLOCAL static GlobalReference<jclass> classInputStream;                     // java.io.InputStream
 
     DLLLOCAL static GlobalReference<jclass> classServiceLoader;                   // java.util.ServiceLoader
     DLLLOCAL static jmethodID methodServiceLoaderIterator;                        // Iterator iterator()
@@ -400,6 +470,27 @@ public:
 
     DLLLOCAL static int typeNull; // java.sql.Type.NULL value
     DLLLOCAL static int typeChar; // java.sql.Type.CHAR value
+    DLLLOCAL static int typeTinyInt; // java.sql.Type.TINYINT value
+    DLLLOCAL static int typeSmallInt; // java.sql.Type.SMALLINT value
+    DLLLOCAL static int typeInteger; // java.sql.Type.INTEGER value
+    DLLLOCAL static int typeBigInt; // java.sql.Type.BIGINT value
+    DLLLOCAL static int typeReal; // java.sql.Type.REAL value
+    DLLLOCAL static int typeFloat; // java.sql.Type.FLOAT value
+    DLLLOCAL static int typeDouble; // java.sql.Type.DOUBLE value
+    DLLLOCAL static int typeBoolean; // java.sql.Type.BOOLEAN value
+    DLLLOCAL static int typeVarchar; // java.sql.Type.VARCHAR value
+    DLLLOCAL static int typeLongVarchar; // java.sql.Type.LONGVARCHAR value
+    DLLLOCAL static int typeNChar; // java.sql.Type.NCHAR value
+    DLLLOCAL static int typeNVarchar; // java.sql.Type.NVARCHAR value
+    DLLLOCAL static int typeLongNVarchar; // java.sql.Type.LONGNVARCHAR value
+    DLLLOCAL static int typeBinary; // java.sql.Type.BINARY value
+    DLLLOCAL static int typeVarBinary; // java.sql.Type.VARBINARY value
+    DLLLOCAL static int typeLongVarBinary; // java.sql.Type.LONGVARBINARY value
+    DLLLOCAL static int typeTimestamp; // java.sql.Type.TIMESTAMP value
+    DLLLOCAL static int typeArray; // java.sql.Type.ARRAY value
+    DLLLOCAL static int typeBlob; // java.sql.Type.BLOB value
+    DLLLOCAL static int typeClob; // java.sql.Type.CLOB value
+    DLLLOCAL static int typeNClob; // java.sql.Type.NCLOB value
 
     DLLLOCAL static GlobalReference<jstring> javaQoreClassField;
 
@@ -430,8 +521,13 @@ public:
         return already_initialized;
     }
 
-    // if already initialized, first tries to find the class, and then defines it only if not found, otherwise
-    // defines the class
+    //! called when qore-jni.jar is on the JVM's class path, so that module classes are loaded from it
+    DLLLOCAL static void setClassesFromJar() {
+        classes_from_jar = true;
+    }
+
+    // if already initialized or if module classes are loaded from qore-jni.jar, first tries to find the class, and
+    // then defines it only if not found, otherwise defines the class
     DLLLOCAL static LocalReference<jclass> findDefineClass(Env& env, const char* name, jobject loader,
             const unsigned char* buf, jsize bufLen);
 
@@ -441,6 +537,9 @@ private:
 
     DLLLOCAL static bool already_initialized;
 
+    //! true if module classes are loaded from qore-jni.jar with the application class loader
+    DLLLOCAL static bool classes_from_jar;
+
     DLLLOCAL static void defineQoreURLClassLoader(Env& env);
 };
 
@@ -469,6 +568,11 @@ private:
     mutable std::vector<QoreExternalProgramLocationWrapper> stack_loc;
 
     mutable bool init = false;
+    //! true if all Java frames have been retrieved
+    mutable bool complete = false;
+
+    //! the number of Java frames retrieved when the stack is first walked; more are retrieved on demand
+    static constexpr jsize JNI_STACK_INITIAL_FRAMES = 16;
 
     DLLLOCAL static std::string jni_no_call_name;
     DLLLOCAL static QoreExternalProgramLocationWrapper jni_loc_builtin;
@@ -478,6 +582,9 @@ private:
     }
 
     DLLLOCAL void checkInit() const;
+
+    //! retrieves up to the given number of Java frames after the frames already retrieved
+    DLLLOCAL void fetch(jsize count) const;
 };
 
 // find the root namespace for the given module in the given QoreProgram
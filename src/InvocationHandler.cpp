@@ -38,8 +38,8 @@ InvocationHandler::InvocationHandler(std::unique_ptr<Dispatcher> dispatcher) {
    jobj = obj.makeGlobal();
 }
 
-InvocationHandler::InvocationHandler(const ResolvedCallReferenceNode *callback)
-      : InvocationHandler(std::unique_ptr<Dispatcher>(new QoreCodeDispatcher(callback))) {
+InvocationHandler::InvocationHandler(const ResolvedCallReferenceNode *callback, bool pass_method_name)
+      : InvocationHandler(std::unique_ptr<Dispatcher>(new QoreCodeDispatcher(callback, pass_method_name))) {
 }
 
 void InvocationHandler::destroy() {
@@ -47,4 +47,15 @@ void InvocationHandler::destroy() {
    env.callVoidMethod(jobj, Globals::methodQoreInvocationHandlerDestroy, nullptr);
 }
 
+void InvocationHandler::startAsync(int threads, int queue_size, int batch_size, bool ordered, bool block) {
+   Env env;
+   jvalue args[5];
+   args[0].i = threads;
+   args[1].i = queue_size;
+   args[2].i = batch_size;
+   args[3].z = ordered;
+   args[4].z = block;
+   env.callVoidMethod(jobj, Globals::methodQoreInvocationHandlerStartAsync, &args[0]);
+}
+
 } // namespace jni
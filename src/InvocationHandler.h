@@ -45,9 +45,19 @@ class InvocationHandler : public QoreJniPrivateData {
 
 public:
    InvocationHandler(std::unique_ptr<Dispatcher> dispatcher);
-   InvocationHandler(const ResolvedCallReferenceNode* callback);
+   InvocationHandler(const ResolvedCallReferenceNode* callback, bool pass_method_name = false);
 
    void destroy();
+
+   /**
+    * \brief Starts dispatching calls to methods without a return value asynchronously in Java worker threads.
+    * \param threads the number of worker threads
+    * \param queue_size the maximum number of queued calls
+    * \param batch_size the maximum number of calls dispatched by a worker thread with a single call to Qore
+    * \param ordered if true, calls made through the same proxy object are dispatched in order
+    * \param block if true, callers block when the queue is full, otherwise the call is rejected
+    */
+   void startAsync(int threads, int queue_size, int batch_size, bool ordered, bool block);
 };
 
 } // namespace jni
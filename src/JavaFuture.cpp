@@ -0,0 +1,252 @@
+//--------------------------------------------------------------------*- C++ -*-
+//
+//  Qore Programming Language
+//
+//  Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+#include "JavaFuture.h"
+#include "Globals.h"
+#include "JavaToQore.h"
+
+#include <chrono>
+
+namespace jni {
+
+//! a thread waiting in JavaFuture::waitAll() or JavaFuture::waitAny()
+class JavaFutureWaiter {
+public:
+    std::mutex m;
+    std::condition_variable cond;
+    //! the number of futures that have completed since the waiter was registered
+    size_t count = 0;
+
+    DLLLOCAL void signal() {
+        std::lock_guard<std::mutex> lock(m);
+        ++count;
+        cond.notify_one();
+    }
+};
+
+JavaFuture::JavaFuture(jobject stage, QoreProgram* pgm)
+        : stage(GlobalReference<jobject>::fromLocal(stage)), pgm(pgm) {
+    pgm->ref();
+}
+
+void JavaFuture::deref(ExceptionSink* xsink) {
+    if (ROdereference()) {
+        for (auto& i : callbacks) {
+            i.success->deref(xsink);
+            if (i.error) {
+                i.error->deref(xsink);
+            }
+        }
+        pgm->deref(xsink);
+        delete this;
+    }
+}
+
+void JavaFuture::listen(Env& env) {
+    // the Java callback holds a reference until the stage completes
+    ref();
+    jvalue jargs[2];
+    jargs[0].l = stage;
+    jargs[1].j = reinterpret_cast<jlong>(this);
+    try {
+        env.callStaticVoidMethod(Globals::classQoreFutureListener, Globals::methodQoreFutureListenerListen,
+            &jargs[0]);
+    } catch (jni::Exception& e) {
+        // the caller still holds a reference
+        ROdereference();
+        throw;
+    }
+}
+
+bool JavaFuture::isDone() const {
+    std::lock_guard<std::mutex> lock(m);
+    return done;
+}
+
+QoreValue JavaFuture::wait(int64 timeout_ms, ExceptionSink* xsink) {
+    {
+        std::unique_lock<std::mutex> lock(m);
+        auto pred = [this] () { return done; };
+        if (timeout_ms < 0) {
+            cond.wait(lock, pred);
+        } else if (!cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), pred)) {
+            xsink->raiseException("JNI-FUTURE-TIMEOUT", "timeout waiting " QLLD " ms for the Java CompletionStage "
+                "to complete", timeout_ms);
+            return QoreValue();
+        }
+    }
+
+    // the result is not modified once the stage has completed
+    if (error) {
+        JavaException e;
+        e.restore(error);
+        e.convert(xsink);
+        return QoreValue();
+    }
+    return result ? JavaToQore::convertToQore(result.toLocal(), pgm) : QoreValue();
+}
+
+void JavaFuture::then(const ResolvedCallReferenceNode* success, const ResolvedCallReferenceNode* error_callback,
+        ExceptionSink* xsink) {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (!done) {
+            callbacks.push_back({success->refRefSelf(), error_callback ? error_callback->refRefSelf() : nullptr});
+            return;
+        }
+    }
+
+    runCallback(success, error_callback, xsink);
+}
+
+void JavaFuture::complete(jobject res, jthrowable err) {
+    std::vector<Callback> cbs;
+    {
+        std::lock_guard<std::mutex> lock(m);
+        assert(!done);
+        if (err) {
+            error = GlobalReference<jthrowable>::fromLocal(err);
+        } else if (res) {
+            result = GlobalReference<jobject>::fromLocal(res);
+        }
+        done = true;
+        cbs.swap(callbacks);
+        for (auto& i : waiters) {
+            i->signal();
+        }
+        waiters.clear();
+    }
+    cond.notify_all();
+
+    printd(LogLevel, "JavaFuture::complete() this: %p err: %p callbacks: %d\n", this, err, (int)cbs.size());
+    if (cbs.empty()) {
+        return;
+    }
+
+    // exceptions raised by the callbacks cannot be returned to the Java thread that completed the stage; they are
+    // reported when the ExceptionSink goes out of scope
+    ExceptionSink xsink;
+    {
+        QoreExternalProgramContextHelper epch(&xsink, pgm);
+        if (!xsink) {
+            for (auto& i : cbs) {
+                runCallback(i.success, i.error, &xsink);
+            }
+        }
+    }
+    for (auto& i : cbs) {
+        i.success->deref(&xsink);
+        if (i.error) {
+            i.error->deref(&xsink);
+        }
+    }
+}
+
+void JavaFuture::runCallback(const ResolvedCallReferenceNode* success,
+        const ResolvedCallReferenceNode* error_callback, ExceptionSink* xsink) {
+    ReferenceHolder<QoreListNode> args(new QoreListNode(autoTypeInfo), xsink);
+    try {
+        if (error) {
+            if (!error_callback) {
+                return;
+            }
+            args->push(JavaToQore::convertToQore(LocalReference<jobject>(error.toLocal()), pgm), xsink);
+            ValueHolder rv(error_callback->execValue(*args, xsink), xsink);
+            return;
+        }
+        args->push(result ? JavaToQore::convertToQore(result.toLocal(), pgm) : QoreValue(), xsink);
+        ValueHolder rv(success->execValue(*args, xsink), xsink);
+    } catch (jni::Exception& e) {
+        e.convert(xsink);
+    }
+}
+
+bool JavaFuture::addWaiter(JavaFutureWaiter* w) {
+    std::lock_guard<std::mutex> lock(m);
+    if (done) {
+        return true;
+    }
+    waiters.push_back(w);
+    return false;
+}
+
+void JavaFuture::removeWaiter(JavaFutureWaiter* w) {
+    std::lock_guard<std::mutex> lock(m);
+    for (auto i = waiters.begin(), e = waiters.end(); i != e; ++i) {
+        if (*i == w) {
+            waiters.erase(i);
+            break;
+        }
+    }
+}
+
+bool JavaFuture::waitAll(const std::vector<JavaFuture*>& futures, int64 timeout_ms) {
+    return !waitIntern(futures, timeout_ms, true);
+}
+
+int JavaFuture::waitAny(const std::vector<JavaFuture*>& futures, int64 timeout_ms) {
+    if (futures.empty() || waitIntern(futures, timeout_ms, false)) {
+        return -1;
+    }
+    for (size_t i = 0, e = futures.size(); i < e; ++i) {
+        if (futures[i]->isDone()) {
+            return (int)i;
+        }
+    }
+    assert(false);
+    return -1;
+}
+
+int JavaFuture::waitIntern(const std::vector<JavaFuture*>& futures, int64 timeout_ms, bool all) {
+    JavaFutureWaiter w;
+    std::vector<JavaFuture*> pending;
+    for (auto& i : futures) {
+        if (!i->addWaiter(&w)) {
+            pending.push_back(i);
+        } else if (!all) {
+            break;
+        }
+    }
+
+    int rc = 0;
+    // a single completed future is enough for waitAny()
+    if (all || pending.size() == futures.size()) {
+        size_t target = all ? pending.size() : 1;
+        std::unique_lock<std::mutex> lock(w.m);
+        auto pred = [&w, target] () { return w.count >= target; };
+        if (timeout_ms < 0) {
+            w.cond.wait(lock, pred);
+        } else if (!w.cond.wait_for(lock, std::chrono::milliseconds(timeout_ms), pred)) {
+            rc = -1;
+        }
+    }
+
+    for (auto& i : pending) {
+        i->removeWaiter(&w);
+    }
+    return rc;
+}
+
+} // namespace jni
@@ -0,0 +1,153 @@
+//--------------------------------------------------------------------*- C++ -*-
+//
+//  Qore Programming Language
+//
+//  Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+///
+/// \file
+/// \brief Defines the JavaFuture class
+///
+//------------------------------------------------------------------------------
+#ifndef QORE_JNI_JAVAFUTURE_H_
+#define QORE_JNI_JAVAFUTURE_H_
+
+#include <qore/Qore.h>
+
+#include "Env.h"
+#include "GlobalReference.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+extern QoreClass* QC_JAVAFUTURE;
+extern qore_classid_t CID_JAVAFUTURE;
+
+namespace jni {
+
+class JavaFutureWaiter;
+
+/**
+ * \brief Receives the result of a java.util.concurrent.CompletionStage in Qore.
+ *
+ * The result is delivered by a Java callback registered with CompletionStage.whenComplete(), so no Qore thread
+ * has to wait for the result.
+ */
+class JavaFuture : public AbstractPrivateData {
+public:
+    /**
+     * \brief Creates the object.
+     * \param stage the java.util.concurrent.CompletionStage object
+     * \param pgm the Qore program used to convert the result and to run callbacks
+     */
+    DLLLOCAL JavaFuture(jobject stage, QoreProgram* pgm);
+
+    /**
+     * \brief Registers the Java completion callback, which holds a reference to the object until the stage
+     * completes.
+     * \param env the JNI environment
+     * \throws Exception if the callback cannot be registered
+     */
+    DLLLOCAL void listen(Env& env);
+
+    DLLLOCAL void deref(ExceptionSink* xsink) override;
+
+    //! returns the CompletionStage object
+    DLLLOCAL const GlobalReference<jobject>& getStage() const {
+        return stage;
+    }
+
+    //! returns true if the CompletionStage has completed
+    DLLLOCAL bool isDone() const;
+
+    /**
+     * \brief Waits for the CompletionStage to complete and returns the result.
+     * \param timeout_ms the maximum time to wait in milliseconds; a negative value means wait forever
+     * \param xsink if the stage completed exceptionally, the exception is raised here
+     * \return the result of the CompletionStage
+     */
+    DLLLOCAL QoreValue wait(int64 timeout_ms, ExceptionSink* xsink);
+
+    /**
+     * \brief Registers callbacks to call when the CompletionStage completes.
+     *
+     * If the stage has already completed, the callback is called immediately in the current thread.
+     * \param success called with the result if the stage completes normally
+     * \param error_callback called with the java.lang.Throwable object if the stage completes exceptionally; may
+     * be null
+     */
+    DLLLOCAL void then(const ResolvedCallReferenceNode* success, const ResolvedCallReferenceNode* error_callback,
+            ExceptionSink* xsink);
+
+    /**
+     * \brief Called by the Java completion callback when the CompletionStage completes.
+     * \param res the result of the stage, if it completed normally
+     * \param err the exception, if the stage completed exceptionally
+     */
+    DLLLOCAL void complete(jobject res, jthrowable err);
+
+    /**
+     * \brief Waits until all of the given futures have completed.
+     * \return true if all futures have completed, false if the timeout expired
+     */
+    DLLLOCAL static bool waitAll(const std::vector<JavaFuture*>& futures, int64 timeout_ms);
+
+    /**
+     * \brief Waits until any of the given futures has completed.
+     * \return the index of the first completed future in the list or -1 if the timeout expired
+     */
+    DLLLOCAL static int waitAny(const std::vector<JavaFuture*>& futures, int64 timeout_ms);
+
+private:
+    struct Callback {
+        ResolvedCallReferenceNode* success;
+        ResolvedCallReferenceNode* error;
+    };
+
+    mutable std::mutex m;
+    std::condition_variable cond;
+    bool done = false;
+    GlobalReference<jobject> stage;
+    GlobalReference<jobject> result;
+    GlobalReference<jthrowable> error;
+    QoreProgram* pgm;
+    //! callbacks registered before the stage completed
+    std::vector<Callback> callbacks;
+    //! threads waiting in waitAll() or waitAny()
+    std::vector<JavaFutureWaiter*> waiters;
+
+    //! returns true if the future is done; otherwise registers the waiter
+    DLLLOCAL bool addWaiter(JavaFutureWaiter* w);
+    DLLLOCAL void removeWaiter(JavaFutureWaiter* w);
+
+    //! calls the success callback with the result or the error callback with the exception
+    DLLLOCAL void runCallback(const ResolvedCallReferenceNode* success,
+            const ResolvedCallReferenceNode* error_callback, ExceptionSink* xsink);
+
+    //! waits for waiters to be notified
+    DLLLOCAL static int waitIntern(const std::vector<JavaFuture*>& futures, int64 timeout_ms, bool all);
+};
+
+} // namespace jni
+
+#endif // QORE_JNI_JAVAFUTURE_H_
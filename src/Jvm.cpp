@@ -31,11 +31,48 @@
 #include "Globals.h"
 #include "QoreJniClassMap.h"
 
+#include <unistd.h>
+
 namespace jni {
 
 JavaVM* Jvm::vm = nullptr;
 thread_local JNIEnv* Jvm::env;
 
+#ifdef QORE_JNI_CDS_ARCHIVE
+// gets the path to the class data sharing archive to use, if any
+static void get_cds_archive(QoreString& path) {
+    // QORE_JNI_CDS_ARCHIVE can give another archive path or disable the archive with "0" or "off"
+    if (!SystemEnvironment::get("QORE_JNI_CDS_ARCHIVE", path)) {
+        if (!strcmp(path.c_str(), "0") || !strcasecmp(path.c_str(), "off")) {
+            path.clear();
+            return;
+        }
+    } else {
+        // the default archive name includes the module version and Java major version, so an archive built for
+        // another version of the module or JVM is never used
+        path = QORE_JNI_CDS_ARCHIVE;
+    }
+    if (!path.empty() && access(path.c_str(), R_OK)) {
+        printd(LogLevel, "CDS archive '%s' not found\n", path.c_str());
+        path.clear();
+    }
+}
+
+// gets the path to qore-jni.jar, from which module classes are loaded so that they can be archived
+static bool get_cds_jar(QoreString& path) {
+    // QORE_JNI_CDS_JAR is also used without an archive when generating the class list for the archive
+    bool set = !SystemEnvironment::get("QORE_JNI_CDS_JAR", path);
+    if (!set) {
+        path = QORE_JNI_CDS_JAR;
+    }
+    if (access(path.c_str(), R_OK)) {
+        printd(LogLevel, "CDS jar '%s' not found\n", path.c_str());
+        path.clear();
+    }
+    return set;
+}
+#endif
+
 QoreStringNode* Jvm::createVM() {
     assert(vm == nullptr);
 
@@ -92,11 +129,33 @@ QoreStringNode* Jvm::createVM() {
                 // add option
                 std::string opt(val.c_str() + pos, i - pos);
                 strvec.push_back(opt);
+                pos = i + 1;
             }
             // add final option
             num_options += strvec.size();
         }
     }
+#ifdef QORE_JNI_CDS_ARCHIVE
+    // check for a class data sharing archive; the archive was dumped with qore-jni.jar on the class path, so the
+    // module's classes must be loaded from the same jar by the application class loader to be used from the archive
+    QoreString cds_archive, cds_jar;
+    get_cds_archive(cds_archive);
+    bool cds_jar_set = get_cds_jar(cds_jar);
+    if (!cds_archive.empty()) {
+        if (cds_jar.empty()) {
+            cds_archive.clear();
+        } else {
+            num_options += 3;
+            cds_archive.prepend("-XX:SharedArchiveFile=");
+        }
+    }
+    if (!cds_jar.empty() && (!cds_archive.empty() || cds_jar_set)) {
+        ++num_options;
+        cds_jar.prepend("-Djava.class.path=");
+    } else {
+        cds_jar.clear();
+    }
+#endif
 #ifdef QORE_JNI_SUPPORT_CLASSPATH
     // this is disabled, because we use our own URLClassloader now to load all classes
     QoreString classpath;
@@ -126,6 +185,21 @@ QoreStringNode* Jvm::createVM() {
         // set maximum heap size
         options[vm_args.nOptions++].optionString = (char*)max_heap.c_str();
     }
+#ifdef QORE_JNI_CDS_ARCHIVE
+    if (!cds_archive.empty()) {
+        printd(LogLevel, "using CDS archive: '%s'\n", cds_archive.c_str());
+        options[vm_args.nOptions++].optionString = (char*)cds_archive.c_str();
+        // the JVM validates the archive and ignores it if it does not match the runtime
+        options[vm_args.nOptions++].optionString = (char*)"-Xshare:auto";
+        // do not output archive validation warnings
+        options[vm_args.nOptions++].optionString = (char*)"-Xlog:cds*=off";
+    }
+    if (!cds_jar.empty()) {
+        printd(LogLevel, "loading module classes from: '%s'\n", cds_jar.c_str());
+        options[vm_args.nOptions++].optionString = (char*)cds_jar.c_str();
+        Globals::setClassesFromJar();
+    }
+#endif
     if (!strvec.empty()) {
         for (auto& str: strvec) {
             //printd(5, "adding JVM pption: '%s'\n", str.c_str());
@@ -196,6 +270,24 @@ JNIEnv* Jvm::attachAndGetEnv(bool& new_attach) {
     return env;
 }
 
+void Jvm::refreshEnv() {
+    if (!vm) {
+        return;
+    }
+    JNIEnv* current_env;
+    if (vm->GetEnv(reinterpret_cast<void**>(&current_env), JNI_VERSION_1_6) == JNI_OK) {
+        env = current_env;
+        return;
+    }
+    // the cached env belongs to a JVM thread that has already exited
+    env = nullptr;
+    try {
+        attachAndGetEnv();
+    } catch (Exception& e) {
+        printd(LogLevel, "JNI - thread %d could not be attached for cleanup\n", q_gettid());
+    }
+}
+
 void Jvm::threadCleanup() {
     if (vm && env) {
         printd(LogLevel, "JNI - detaching thread, env: %p\n", env);
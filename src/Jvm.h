@@ -102,6 +102,14 @@ public:
      */
     static void threadCleanup();
 
+    /**
+     * \brief Makes sure that the current thread is attached to the JVM while it is being released from Qore.
+     *
+     * Called when a thread terminates; the JVM may already have detached a terminating Java thread, in which case
+     * the thread is attached again so that Java references held by Qore thread-local data can be released.
+     */
+    static void refreshEnv();
+
 private:
     /**
      * \brief This is a static class - no instances are allowed.
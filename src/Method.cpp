@@ -216,39 +216,7 @@ QoreValue BaseMethod::invoke(jobject object, const QoreListNode* args, QoreProgr
     if (!jpc) {
         // make a standard Java call; there will be no Java context for security access though
         try {
-            std::vector<jvalue> jargs = convertArgs(env, args, offset, jpc);
-            switch (retValType) {
-                case Type::Boolean:
-                    return JavaToQore::convert(env.callBooleanMethod(object, id, &jargs[0]));
-                case Type::Byte:
-                    return JavaToQore::convert(env.callByteMethod(object, id, &jargs[0]));
-                case Type::Char:
-                    return JavaToQore::convert(env.callCharMethod(object, id, &jargs[0]));
-                case Type::Short:
-                    return JavaToQore::convert(env.callShortMethod(object, id, &jargs[0]));
-                case Type::Int:
-                    return JavaToQore::convert(env.callIntMethod(object, id, &jargs[0]));
-                case Type::Long:
-                    return JavaToQore::convert(env.callLongMethod(object, id, &jargs[0]));
-                case Type::Float:
-                    return JavaToQore::convert(env.callFloatMethod(object, id, &jargs[0]));
-                case Type::Double:
-                    return JavaToQore::convert(env.callDoubleMethod(object, id, &jargs[0]));
-                case Type::Reference: {
-                    if (!pgm) {
-                        pgm = jni_get_program_context();
-                        if (!pgm) {
-                            pgm = Globals::getJavaContextProgram();
-                        }
-                    }
-                    return JavaToQore::convertToQore(env.callObjectMethod(object, id, &jargs[0]), pgm, false);
-                }
-                case Type::Void:
-                default:
-                    assert(retValType == Type::Void);
-                    env.callVoidMethod(object, id, &jargs[0]);
-                    return QoreValue();
-            }
+            return invokeDirect(env, object, args, pgm, jpc, offset);
         } catch (JavaException& e) {
             // workaround for https://bugs.openjdk.java.net/browse/JDK-8221530
             if (e.checkBug_8221530()) {
@@ -273,6 +241,44 @@ QoreValue BaseMethod::invoke(jobject object, const QoreListNode* args, QoreProgr
         &jargs[0]), pgm, jpc->getCompatTypes());
 }
 
+QoreValue BaseMethod::invokeDirect(Env& env, jobject object, const QoreListNode* args, QoreProgram* pgm,
+        JniExternalProgramData* jpc, int offset) const {
+    std::vector<jvalue> jargs = convertArgs(env, args, offset, jpc);
+    switch (retValType) {
+        case Type::Boolean:
+            return JavaToQore::convert(env.callBooleanMethod(object, id, &jargs[0]));
+        case Type::Byte:
+            return JavaToQore::convert(env.callByteMethod(object, id, &jargs[0]));
+        case Type::Char:
+            return JavaToQore::convert(env.callCharMethod(object, id, &jargs[0]));
+        case Type::Short:
+            return JavaToQore::convert(env.callShortMethod(object, id, &jargs[0]));
+        case Type::Int:
+            return JavaToQore::convert(env.callIntMethod(object, id, &jargs[0]));
+        case Type::Long:
+            return JavaToQore::convert(env.callLongMethod(object, id, &jargs[0]));
+        case Type::Float:
+            return JavaToQore::convert(env.callFloatMethod(object, id, &jargs[0]));
+        case Type::Double:
+            return JavaToQore::convert(env.callDoubleMethod(object, id, &jargs[0]));
+        case Type::Reference: {
+            if (!pgm) {
+                pgm = jni_get_program_context();
+                if (!pgm) {
+                    pgm = Globals::getJavaContextProgram();
+                }
+            }
+            return JavaToQore::convertToQore(env.callObjectMethod(object, id, &jargs[0]), pgm,
+                jpc ? jpc->getCompatTypes() : false);
+        }
+        case Type::Void:
+        default:
+            assert(retValType == Type::Void);
+            env.callVoidMethod(object, id, &jargs[0]);
+            return QoreValue();
+    }
+}
+
 QoreValue BaseMethod::invokeNonvirtual(jobject object, const QoreListNode* args, QoreProgram* pgm, int offset) const {
     Env env;
     if (!env.isInstanceOf(object, cls->getJavaObject())) {
@@ -117,6 +117,23 @@ public:
      */
     QoreValue invoke(jobject object, const QoreListNode* args, QoreProgram* pgm, int offset = 0) const;
 
+    /**
+     * \brief Invokes an instance method directly with JNI without the dynamic API.
+     *
+     * Arguments are passed without boxing them in an Object[] array; there is no Java context for security access,
+     * so this must only be used for methods that are always accessible, such as interface methods.
+     * \param env the JNI environment
+     * \param object the instance, which must be an instance of the method's class
+     * \param args the arguments
+     * \param pgm the program used to convert the return value
+     * \param jpc the jni module context of the program for converting arguments; may be null
+     * \param offset the offset in args for the arguments
+     * \return the return value
+     * \throws Exception if the arguments do not match the descriptor or if the method throws
+     */
+    QoreValue invokeDirect(Env& env, jobject object, const QoreListNode* args, QoreProgram* pgm,
+            JniExternalProgramData* jpc, int offset = 0) const;
+
     /**
      * \brief Invokes an instance method non-virtually.
      * \param object the instance
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------*- C++ -*-
+//
+//  Qore Programming Language
+//
+//  Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+#include "ParallelMap.h"
+#include "Globals.h"
+#include "JavaToQore.h"
+#include "QoreJniClassMap.h"
+
+namespace jni {
+
+ParallelMap::ParallelMap(const ResolvedCallReferenceNode* fn, QoreProgram* pgm) : fn(fn), pgm(pgm), failed(false) {
+    JniExternalProgramData* jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
+    compat_types = jpc ? jpc->getCompatTypes() : false;
+}
+
+QoreListNode* ParallelMap::run(Env& env, jobject collection, int parallelism, int64 batch_size,
+        ExceptionSink* xsink) {
+    jvalue jargs[4];
+    jargs[0].j = reinterpret_cast<jlong>(this);
+    jargs[1].l = collection;
+    jargs[2].i = parallelism;
+    jargs[3].j = batch_size;
+
+    // all worker tasks have completed when the call returns, even if it throws an exception
+    ExceptionSink java_xsink;
+    try {
+        env.callStaticLongMethod(Globals::classQoreParallelMap, Globals::methodQoreParallelMapMap, &jargs[0]);
+    } catch (jni::Exception& e) {
+        e.convert(&java_xsink);
+    }
+
+    ReferenceHolder<QoreListNode> rv(new QoreListNode(autoTypeInfo), xsink);
+    for (auto& i : results) {
+        rv->push(i, xsink);
+    }
+    results.clear();
+
+    printd(LogLevel, "ParallelMap::run() this: %p size: %d failed: %d\n", this, (int)rv->size(), (int)failed.load());
+    if (failed.load()) {
+        xsink->assimilate(&error);
+    }
+    if (java_xsink) {
+        xsink->assimilate(&java_xsink);
+    }
+    return *xsink ? nullptr : rv.release();
+}
+
+void ParallelMap::start(size_t size) {
+    results.resize(size);
+}
+
+bool ParallelMap::apply(Env& env, jobject value, jlong pos) {
+    if (failed.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    ExceptionSink xsink;
+    {
+        QoreExternalProgramContextHelper pch(&xsink, pgm);
+        if (!xsink) {
+            try {
+                if (pos < 0 || (size_t)pos >= results.size()) {
+                    xsink.raiseException("JNI-PARALLEL-MAP-ERROR", "element " QLLD " is beyond the end of the "
+                        "collection with %d element(s); the collection was modified while it was being processed",
+                        (int64)pos, (int)results.size());
+                } else {
+                    ReferenceHolder<QoreListNode> args(new QoreListNode(autoTypeInfo), &xsink);
+                    args->push(JavaToQore::convertToQore(value, pgm, compat_types), &xsink);
+                    ValueHolder val(fn->execValue(*args, &xsink), &xsink);
+                    if (!xsink) {
+                        results[pos] = val.release();
+                    }
+                }
+            } catch (jni::Exception& e) {
+                e.convert(&xsink);
+            }
+        }
+    }
+
+    if (!xsink) {
+        return true;
+    }
+
+    // only the first exception is reported
+    std::lock_guard<std::mutex> lock(m);
+    if (!failed.load()) {
+        error.assimilate(&xsink);
+        failed.store(true);
+    } else {
+        xsink.clear();
+    }
+    return false;
+}
+
+} // namespace jni
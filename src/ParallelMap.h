@@ -0,0 +1,105 @@
+//--------------------------------------------------------------------*- C++ -*-
+//
+//  Qore Programming Language
+//
+//  Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+///
+/// \file
+/// \brief Defines the ParallelMap class
+///
+//------------------------------------------------------------------------------
+#ifndef QORE_JNI_PARALLELMAP_H_
+#define QORE_JNI_PARALLELMAP_H_
+
+#include <qore/Qore.h>
+
+#include "Env.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace jni {
+
+/**
+ * \brief Applies a Qore closure to the elements of a Java collection in Java worker threads.
+ *
+ * The collection is split and iterated in a ForkJoinPool by org.qore.jni.QoreParallelMap; each element is converted
+ * and passed to the closure in the worker thread, and the result is stored at the element's position, so no
+ * conversion of the collection or the results is done by the calling thread.
+ */
+class ParallelMap {
+public:
+    /**
+     * \brief Creates the object.
+     * \param fn the closure to call for each element
+     * \param pgm the Qore program used to convert the elements and to call the closure
+     */
+    DLLLOCAL ParallelMap(const ResolvedCallReferenceNode* fn, QoreProgram* pgm);
+
+    /**
+     * \brief Applies the closure to all elements of the collection and returns the results.
+     * \param env the JNI environment
+     * \param collection the java.util.Collection object
+     * \param parallelism the number of worker threads; if 0, the shared pool is used
+     * \param batch_size the maximum number of elements processed by a task; if 0, it is calculated from the size of
+     * the collection
+     * \param xsink the first exception raised by the closure or any Java exception is raised here
+     * \return the results in the order of the elements in the collection
+     */
+    DLLLOCAL QoreListNode* run(Env& env, jobject collection, int parallelism, int64 batch_size,
+            ExceptionSink* xsink);
+
+    /**
+     * \brief Called from Java before any elements are processed to allocate storage for the results.
+     * \param size the number of elements in the collection
+     */
+    DLLLOCAL void start(size_t size);
+
+    /**
+     * \brief Called from a Java worker thread to apply the closure to an element.
+     * \param env the JNI environment
+     * \param value the element
+     * \param pos the position of the element in the collection
+     * \return false if an exception was raised, in which case no further elements should be processed
+     */
+    DLLLOCAL bool apply(Env& env, jobject value, jlong pos);
+
+private:
+    const ResolvedCallReferenceNode* fn;
+    QoreProgram* pgm;
+    bool compat_types;
+    //! the results; each element is only written by the thread that processes the element at that position
+    std::vector<QoreValue> results;
+    //! set when the first exception is raised
+    std::atomic<bool> failed;
+    //! protects error
+    std::mutex m;
+    //! the first exception raised by the closure
+    ExceptionSink error;
+};
+
+} // namespace jni
+
+#endif // QORE_JNI_PARALLELMAP_H_
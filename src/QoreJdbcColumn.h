@@ -0,0 +1,95 @@
+/* -*- mode: c++; indent-tabs-mode: nil -*- */
+/*
+    QoreJdbcColumn.h
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _QORE_JNI_QOREJDBCCOLUMN_H
+
+#define _QORE_JNI_QOREJDBCCOLUMN_H
+
+#include <qore/Qore.h>
+
+#include <jni.h>
+
+#include <vector>
+#include <string>
+
+namespace jni {
+
+//! Column value fetch strategies; determined from the column's java.sql.Types value
+enum JdbcFetchType {
+    //! ResultSet.getObject() and generic conversion
+    JFT_OBJECT = 0,
+    //! ResultSet.getLong() and ResultSet.wasNull()
+    JFT_LONG,
+    //! ResultSet.getDouble() and ResultSet.wasNull()
+    JFT_DOUBLE,
+    //! ResultSet.getBoolean() and ResultSet.wasNull()
+    JFT_BOOLEAN,
+    //! ResultSet.getString()
+    JFT_STRING,
+    //! ResultSet.getBytes()
+    JFT_BYTES,
+    //! ResultSet.getTimestamp()
+    JFT_TIMESTAMP,
+    //! ResultSet.getBlob() returned as an org.qore.jni.JdbcLobStream
+    JFT_BLOB,
+    //! ResultSet.getClob() returned as an org.qore.jni.JdbcLobStream
+    JFT_CLOB,
+};
+
+//! Result set column description
+struct QoreJdbcColumn {
+    //! Column name in the DB
+    std::string name;
+
+    //! Column name in the output query
+    std::string qname;
+
+    //! The java.sql.Types value for the column
+    jint ctype;
+
+    //! Strip trailing spaces from string values retrieved (CHAR columns)
+    bool strip = false;
+
+    //! The fetch strategy for column values
+    JdbcFetchType fetch_type = JFT_OBJECT;
+
+    //! Constructor
+    /** @param name the column name in the DB
+        @param qname the column name in the output
+        @param ctype the java.sql.Types value for the column
+        @param is_signed true if numeric values in the column are signed
+        @param lob_streams true if LOB values are returned as streams
+    */
+    DLLLOCAL QoreJdbcColumn(std::string&& name, std::string&& qname, jint ctype, bool is_signed = true,
+            bool lob_streams = false);
+
+    //! Returns the fetch strategy for the given java.sql.Types value
+    DLLLOCAL static JdbcFetchType getFetchType(jint ctype, bool is_signed, bool lob_streams);
+};
+
+// column vector
+typedef std::vector<QoreJdbcColumn> cvec_t;
+
+}
+
+#endif
@@ -29,7 +29,9 @@
 #include "QoreToJava.h"
 #include "Env.h"
 
+#include <algorithm>
 #include <vector>
+#include <climits>
 
 namespace jni {
 
@@ -60,34 +62,49 @@ QoreJdbcConnection::QoreJdbcConnection(Datasource* ds, ExceptionSink* xsink) : d
     }
 
     // determine DB type
+    BusyHelper busy(*env, *this);
     LocalReference<jobject> md = env.callObjectMethod(connection, Globals::methodConnectionGetMetaData, nullptr);
     if (!md) {
         return;
     }
 
-#if 0
-    LocalReference<jstring> str = env.callObjectMethod(md,
-        Globals::methodDatabaseMetaDataGetDatabaseProductName, nullptr).as<jstring>();
-    if (str) {
-        Env::GetStringUtfChars jname(env, str);
-        QoreString product_name(jname.c_str());
-        product_name.tolwr();
-        if (product_name.startsWith("oracle")) {
-            dbtype = DBT_ORACLE;
-            array_support = DAS_SUPPORTED;
-            LocalReference<jclass> cls = env.callObjectMethod(connection, Globals::methodObjectGetClass, nullptr)
-                .as<jclass>();
-            methodOracleConnectionCreateOracleArray = env.getMethod(cls, "createOracleArray",
-                "(Ljava/lang/String;Ljava/lang/Object;)Ljava/sql/Array;");
+    try {
+        LocalReference<jstring> str = env.callObjectMethod(md,
+            Globals::methodDatabaseMetaDataGetDatabaseProductName, nullptr).as<jstring>();
+        if (str) {
+            Env::GetStringUtfChars jname(env, str);
+            QoreString product_name(jname.c_str());
+            product_name.tolwr();
+            if (product_name.startsWith("oracle")) {
+                dbtype = DBT_ORACLE;
+                // Oracle does not support Connection.createArrayOf()
+                array_support = DAS_NOT_SUPPORTED;
+                LocalReference<jclass> cls = env.callObjectMethod(connection, Globals::methodObjectGetClass,
+                    nullptr).as<jclass>();
+                methodOracleConnectionCreateOracleArray = env.getMethod(cls, "createOracleArray",
+                    "(Ljava/lang/String;Ljava/lang/Object;)Ljava/sql/Array;");
+            }
         }
+    } catch (JavaException& e) {
+        // the connection class may be a wrapper without createOracleArray(); arrays are then created with
+        // Connection.createArrayOf()
+        e.ignore();
     }
-#endif
 }
 
 QoreJdbcConnection::~QoreJdbcConnection() {
     assert(!connection);
 }
 
+// closes a statement without throwing C++ exceptions; any new Java exception is cleared
+static void close_statement(JNIEnv* env, jobject stmt) {
+    bool active_java_exception = env->ExceptionCheck();
+    env->CallVoidMethodA(stmt, Globals::methodPreparedStatementClose, nullptr);
+    if (!active_java_exception && env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+}
+
 int QoreJdbcConnection::reconnect(Env& env, ExceptionSink* xsink) {
     close(env);
     return connect(env, xsink);
@@ -132,10 +149,15 @@ int QoreJdbcConnection::connect(Env& env, ExceptionSink* xsink) {
             .makeGlobal();
 
         printd(5, "QoreJdbcConnection::connect() got connection: %p\n", (jobject)connection);
+        ++conn_gen;
 
         // turn off autocommit
         jargs[0].z = false;
         env.callVoidMethod(connection, Globals::methodConnectionSetAutoCommit, &jargs[0]);
+
+        if (keepalive_interval) {
+            startKeepalive(env);
+        }
     } catch (jni::Exception& e) {
         e.convert(xsink);
         xsink->appendLastDescription(" (using JDBC URL: '%s')", url.c_str());
@@ -162,6 +184,9 @@ int QoreJdbcConnection::close(Env& env) {
         return 0;
     }
     JavaExceptionRethrowHelper erh;
+    stopKeepalive(*env);
+    // cached statements cannot be used after the connection is closed
+    clearStatementCache(*env);
     env.callVoidMethod(connection, Globals::methodConnectionClose, nullptr);
     connection = nullptr;
 
@@ -226,6 +251,99 @@ int QoreJdbcConnection::setOption(const char* opt, const QoreValue val, Exceptio
             return -1;
         }
         db = val.get<const QoreStringNode>()->c_str();
+    } else if (!strcasecmp(opt, JDBC_OPT_STMT_CACHE_SIZE)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_STMT_CACHE_SIZE, size);
+            return -1;
+        }
+        stmt_cache_size = size;
+        if (stmt_cache.size() > stmt_cache_size) {
+            try {
+                Env env;
+                trimStatementCache(*env, stmt_cache_size);
+            } catch (jni::Exception& e) {
+                e.convert(xsink);
+                return -1;
+            }
+        }
+    } else if (!strcasecmp(opt, JDBC_OPT_FETCH_SIZE)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0 || size > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_FETCH_SIZE, size);
+            return -1;
+        }
+        fetch_size = (int)size;
+    } else if (!strcasecmp(opt, JDBC_OPT_BATCH_SIZE)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0 || size > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_BATCH_SIZE, size);
+            return -1;
+        }
+        batch_size = (int)size;
+    } else if (!strcasecmp(opt, JDBC_OPT_FETCH_BLOCK_SIZE)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0 || size > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_FETCH_BLOCK_SIZE, size);
+            return -1;
+        }
+        fetch_block_size = (int)size;
+    } else if (!strcasecmp(opt, JDBC_OPT_PREFETCH_BLOCKS)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0 || size > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_PREFETCH_BLOCKS, size);
+            return -1;
+        }
+        prefetch_blocks = (int)size;
+    } else if (!strcasecmp(opt, JDBC_OPT_LOB_STREAMS)) {
+        lob_streams = val.getAsBool();
+    } else if (!strcasecmp(opt, JDBC_OPT_STREAM_BIND_SIZE)) {
+        int64 size = val.getAsBigInt();
+        if (size < 0 || size > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_STREAM_BIND_SIZE, size);
+            return -1;
+        }
+        stream_bind_size = (int)size;
+    } else if (!strcasecmp(opt, JDBC_OPT_VALIDATION_INTERVAL)) {
+        int64 ms = val.getAsBigInt();
+        if (ms < 0 || ms > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_VALIDATION_INTERVAL, ms);
+            return -1;
+        }
+        validation_interval = (int)ms;
+    } else if (!strcasecmp(opt, JDBC_OPT_KEEPALIVE_INTERVAL)) {
+        int64 ms = val.getAsBigInt();
+        if (ms < 0 || ms > INT_MAX) {
+            xsink->raiseException("JDBC-OPTION-ERROR", "'%s' expects a non-negative integer; got %lld",
+                JDBC_OPT_KEEPALIVE_INTERVAL, ms);
+            return -1;
+        }
+        if (keepalive_interval != (int)ms) {
+            keepalive_interval = (int)ms;
+            // restart background validation with the new interval if already connected
+            if (connection) {
+                try {
+                    Env env;
+                    stopKeepalive(*env);
+                    if (keepalive_interval) {
+                        startKeepalive(env);
+                    }
+                } catch (jni::Exception& e) {
+                    e.convert(xsink);
+                    return -1;
+                }
+            }
+        }
+    } else if (!strcasecmp(opt, JDBC_OPT_STMT_CACHE_STATS)) {
+        xsink->raiseException("JDBC-OPTION-ERROR", "option '%s' is read-only", opt);
+        return -1;
     } else if (!strcasecmp(opt, DBI_OPT_NUMBER_OPT)) {
         numeric = ENO_OPTIMAL;
     } else if (!strcasecmp(opt, DBI_OPT_NUMBER_STRING)) {
@@ -244,6 +362,31 @@ QoreValue QoreJdbcConnection::getOption(const char* opt) {
         return classpath.empty() ? QoreValue() : new QoreStringNode(classpath);
     } else if (!strcasecmp(opt, JDBC_OPT_URL)) {
         return db.empty() ? QoreValue() : new QoreStringNode(db);
+    } else if (!strcasecmp(opt, JDBC_OPT_STMT_CACHE_SIZE)) {
+        return (int64)stmt_cache_size;
+    } else if (!strcasecmp(opt, JDBC_OPT_FETCH_SIZE)) {
+        return (int64)fetch_size;
+    } else if (!strcasecmp(opt, JDBC_OPT_BATCH_SIZE)) {
+        return (int64)batch_size;
+    } else if (!strcasecmp(opt, JDBC_OPT_FETCH_BLOCK_SIZE)) {
+        return (int64)fetch_block_size;
+    } else if (!strcasecmp(opt, JDBC_OPT_PREFETCH_BLOCKS)) {
+        return (int64)prefetch_blocks;
+    } else if (!strcasecmp(opt, JDBC_OPT_LOB_STREAMS)) {
+        return lob_streams;
+    } else if (!strcasecmp(opt, JDBC_OPT_STREAM_BIND_SIZE)) {
+        return (int64)stream_bind_size;
+    } else if (!strcasecmp(opt, JDBC_OPT_VALIDATION_INTERVAL)) {
+        return (int64)validation_interval;
+    } else if (!strcasecmp(opt, JDBC_OPT_KEEPALIVE_INTERVAL)) {
+        return (int64)keepalive_interval;
+    } else if (!strcasecmp(opt, JDBC_OPT_STMT_CACHE_STATS)) {
+        QoreHashNode* h = new QoreHashNode(autoTypeInfo);
+        h->setKeyValue("size", (int64)stmt_cache_size, nullptr);
+        h->setKeyValue("count", (int64)stmt_cache.size(), nullptr);
+        h->setKeyValue("hits", stmt_cache_hits, nullptr);
+        h->setKeyValue("misses", stmt_cache_misses, nullptr);
+        return h;
     } else if (!strcasecmp(opt, DBI_OPT_NUMBER_OPT)) {
         return numeric == ENO_OPTIMAL;
     } else if (!strcasecmp(opt, DBI_OPT_NUMBER_STRING)) {
@@ -256,7 +399,214 @@ QoreValue QoreJdbcConnection::getOption(const char* opt) {
     return QoreValue();
 }
 
-#if 0
+GlobalReference<jobject> QoreJdbcConnection::acquireStatement(Env& env, const std::string& sql, unsigned& gen,
+        cvec_t& cvec) {
+    gen = conn_gen;
+    // the connection is not validated in the background while statements are active
+    enterBusy(*env);
+    stopPrefetchers(*env);
+    try {
+        return acquireStatementIntern(env, sql, cvec);
+    } catch (jni::Exception& e) {
+        // the statement will not be released
+        exitBusy(*env);
+        throw;
+    }
+}
+
+GlobalReference<jobject> QoreJdbcConnection::acquireStatementIntern(Env& env, const std::string& sql,
+        cvec_t& cvec) {
+    if (stmt_cache_size) {
+        stmt_cache_map_t::iterator i = stmt_cache_map.find(sql);
+        if (i != stmt_cache_map.end()) {
+            ++stmt_cache_hits;
+            // the statement is owned by the caller until it is released
+            GlobalReference<jobject> rv = std::move(i->second->second.stmt);
+            cvec = std::move(i->second->second.cvec);
+            stmt_cache.erase(i->second);
+            stmt_cache_map.erase(i);
+            // always set the fetch size on cached statements, as the option may have changed
+            jvalue jarg;
+            jarg.i = fetch_size;
+            env.callVoidMethod(rv, Globals::methodPreparedStatementSetFetchSize, &jarg);
+            return rv;
+        }
+        ++stmt_cache_misses;
+    }
+
+    // no exception handling needed; calls must be wrapped in a try/catch block
+    std::vector<jvalue> jargs(1);
+    LocalReference<jstring> jstr = env.newString(sql.c_str());
+    jargs[0].l = jstr;
+
+    GlobalReference<jobject> rv = env.callObjectMethod(connection, Globals::methodConnectionPrepareStatement,
+        &jargs[0]).makeGlobal();
+    if (fetch_size) {
+        jargs[0].i = fetch_size;
+        env.callVoidMethod(rv, Globals::methodPreparedStatementSetFetchSize, &jargs[0]);
+    }
+    return rv;
+}
+
+void QoreJdbcConnection::releaseStatement(JNIEnv* env, const std::string& sql, unsigned gen, bool batch,
+        GlobalReference<jobject>& stmt, cvec_t& cvec) {
+    assert(stmt);
+    exitBusy(env);
+    // only cache statements from the current connection if there is no active Java exception and the same SQL is
+    // not already cached
+    if (!stmt_cache_size || gen != conn_gen || !connection || env->ExceptionCheck()
+        || stmt_cache_map.find(sql) != stmt_cache_map.end()) {
+        close_statement(env, stmt);
+        stmt = nullptr;
+        return;
+    }
+
+    // reset the statement for reuse
+    env->CallVoidMethodA(stmt, Globals::methodPreparedStatementClearParameters, nullptr);
+    if (batch && !env->ExceptionCheck()) {
+        env->CallVoidMethodA(stmt, Globals::methodPreparedStatementClearBatch, nullptr);
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        close_statement(env, stmt);
+        stmt = nullptr;
+        return;
+    }
+
+    stmt_cache.emplace_front(sql, CachedStatement{std::move(stmt), std::move(cvec)});
+    stmt_cache_map[sql] = stmt_cache.begin();
+    stmt = nullptr;
+
+    trimStatementCache(env, stmt_cache_size);
+}
+
+// SQLState classes that indicate errors in the statement or its data, where the connection does not need to be
+// validated: cardinality violation, data exception, integrity constraint violation, invalid transaction state,
+// triggered data change violation, transaction rollback, syntax error or access rule violation, and with check
+// option violation
+static const char* no_validation_classes[] = {"21", "22", "23", "25", "27", "40", "42", "44", nullptr};
+
+bool QoreJdbcConnection::needsValidation(Env& env, jthrowable ex) {
+    LocalReference<jstring> jstate = env.callObjectMethod(ex, Globals::methodSQLExceptionGetSQLState, nullptr)
+        .as<jstring>();
+    if (jstate) {
+        Env::GetStringUtfChars state(env, jstate);
+        const char* str = state.c_str();
+        if (strlen(str) >= 2) {
+            // connection exception
+            if (!strncmp(str, "08", 2)) {
+                return true;
+            }
+            for (const char** p = no_validation_classes; *p; ++p) {
+                if (!strncmp(str, *p, 2)) {
+                    printd(5, "QoreJdbcConnection::needsValidation() SQLState '%s': no validation\n", str);
+                    return false;
+                }
+            }
+        }
+    }
+    // skip validation if the connection was known to be valid recently
+    return !validation_interval || (q_clock_getmicros() - last_validated) >= (int64)validation_interval * 1000;
+}
+
+bool QoreJdbcConnection::validate(Env& env) {
+    // 1 second timeout
+    jvalue jarg;
+    jarg.i = 1;
+    bool rc = env.callBooleanMethod(connection, Globals::methodConnectionIsValid, &jarg);
+    if (rc) {
+        last_validated = q_clock_getmicros();
+    }
+    return rc;
+}
+
+void QoreJdbcConnection::startKeepalive(Env& env) {
+    assert(connection);
+    assert(!keepalive);
+    keepalive_invalid.store(false, std::memory_order_relaxed);
+    std::vector<jvalue> jargs(3);
+    jargs[0].l = connection;
+    jargs[1].i = keepalive_interval;
+    // the keepalive object sets the flag with a native call; it is not used after JdbcKeepalive.close() returns
+    jargs[2].j = reinterpret_cast<jlong>(&keepalive_invalid);
+    keepalive = env.newObject(Globals::classJdbcKeepalive, Globals::ctorJdbcKeepalive, &jargs[0]).makeGlobal();
+    if (busy_count) {
+        setKeepaliveBusy(*env, true);
+    }
+}
+
+void QoreJdbcConnection::stopKeepalive(JNIEnv* env) {
+    if (!keepalive) {
+        return;
+    }
+    // preserves any pending Java exception
+    JavaExceptionRethrowHelper erh;
+    env->CallVoidMethodA(keepalive, Globals::methodJdbcKeepaliveClose, nullptr);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+    keepalive = nullptr;
+    keepalive_invalid.store(false, std::memory_order_relaxed);
+}
+
+void QoreJdbcConnection::setKeepaliveBusy(JNIEnv* env, bool busy) {
+    if (!keepalive) {
+        return;
+    }
+    // preserves any pending Java exception
+    JavaExceptionRethrowHelper erh;
+    jvalue jarg;
+    jarg.z = busy;
+    env->CallVoidMethodA(keepalive, Globals::methodJdbcKeepaliveSetBusy, &jarg);
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+}
+
+void QoreJdbcConnection::addPrefetcher(JNIEnv* env, jobject prefetcher) {
+    prefetchers.push_back(prefetcher);
+    enterBusy(env);
+}
+
+void QoreJdbcConnection::removePrefetcher(JNIEnv* env, jobject prefetcher) {
+    std::vector<jobject>::iterator i = std::find(prefetchers.begin(), prefetchers.end(), prefetcher);
+    if (i == prefetchers.end()) {
+        return;
+    }
+    prefetchers.erase(i);
+    exitBusy(env);
+}
+
+void QoreJdbcConnection::stopPrefetchers(JNIEnv* env, jobject except) {
+    if (prefetchers.empty() || (prefetchers.size() == 1 && prefetchers[0] == except)) {
+        return;
+    }
+    // preserves any pending Java exception
+    JavaExceptionRethrowHelper erh;
+    for (jobject prefetcher : prefetchers) {
+        if (prefetcher == except) {
+            continue;
+        }
+        env->CallVoidMethodA(prefetcher, Globals::methodJdbcRowPrefetcherStop, nullptr);
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+        }
+    }
+}
+
+void QoreJdbcConnection::clearStatementCache(JNIEnv* env) {
+    trimStatementCache(env, 0);
+}
+
+void QoreJdbcConnection::trimStatementCache(JNIEnv* env, size_t size) {
+    while (stmt_cache.size() > size) {
+        stmt_cache_entry_t& e = stmt_cache.back();
+        close_statement(env, e.second.stmt);
+        stmt_cache_map.erase(e.first);
+        stmt_cache.pop_back();
+    }
+}
+
 bool QoreJdbcConnection::areArraysSupported(Env& env) {
     if (array_support == DAS_SUPPORTED) {
         return true;
@@ -274,34 +624,44 @@ bool QoreJdbcConnection::areArraysSupported(Env& env) {
     }
 
     // try to create an array of strings
-    ExceptionSink xsink;
-    ReferenceHolder<QoreListNode> l(new QoreListNode(autoTypeInfo), &xsink);
-    l->push(new QoreStringNode("x"), &xsink);
-    LocalReference<jobject> array_arg = QoreToJava::toAnyObject(env, *l, jpc);
+    LocalReference<jobjectArray> elements = env.newObjectArray(1, Globals::classString);
+    LocalReference<jstring> x = env.newString("x");
+    env.setObjectArrayElement(elements, 0, x);
 
     std::vector<jvalue> jargs(2);
-    LocalReference<jstring> jurl = env.newString("VARCHAR");
-    jargs[0].l = jurl;
-    jargs[1].l = array_arg;
+    LocalReference<jstring> jtype = env.newString("varchar");
+    jargs[0].l = jtype;
+    jargs[1].l = elements;
     try {
         LocalReference<jobject> array = env.callObjectMethod(connection, Globals::methodConnectionCreateArrayOf,
             &jargs[0]);
-        printd(0, "QoreJdbcConnection::areArraysSupported() OK\n");
+        printd(5, "QoreJdbcConnection::areArraysSupported() OK\n");
         array_support = DAS_SUPPORTED;
         return true;
     } catch (JavaException& e) {
         SimpleRefHolder<QoreStringNode> errtxt(e.toString(false));
-        printd(0, "QoreJdbcConnection::areArraysSupported() %s\n", errtxt->c_str());
+        printd(5, "QoreJdbcConnection::areArraysSupported() %s\n", errtxt->c_str());
         e.ignore();
     }
     array_support = DAS_NOT_SUPPORTED;
     return false;
 }
-#endif
+
+LocalReference<jobject> QoreJdbcConnection::createArray(Env& env, const char* type, jobjectArray elements) {
+    std::vector<jvalue> jargs(2);
+    LocalReference<jstring> jtype = env.newString(type);
+    jargs[0].l = jtype;
+    jargs[1].l = elements;
+    if (methodOracleConnectionCreateOracleArray) {
+        return env.callObjectMethod(connection, methodOracleConnectionCreateOracleArray, &jargs[0]);
+    }
+    return env.callObjectMethod(connection, Globals::methodConnectionCreateArrayOf, &jargs[0]);
+}
 
 int QoreJdbcConnection::commit(ExceptionSink* xsink) {
     assert(connection);
     Env env;
+    BusyHelper busy(*env, *this);
     try {
         env.callVoidMethod(connection, Globals::methodConnectionCommit, nullptr);
     } catch (jni::Exception& e) {
@@ -313,6 +673,7 @@ int QoreJdbcConnection::commit(ExceptionSink* xsink) {
 int QoreJdbcConnection::rollback(ExceptionSink* xsink) {
     assert(connection);
     Env env;
+    BusyHelper busy(*env, *this);
     try {
         env.callVoidMethod(connection, Globals::methodConnectionRollback, nullptr);
     } catch (jni::Exception& e) {
@@ -324,6 +685,7 @@ int QoreJdbcConnection::rollback(ExceptionSink* xsink) {
 QoreValue QoreJdbcConnection::getServerVersion(ExceptionSink* xsink) {
     assert(connection);
     Env env;
+    BusyHelper busy(*env, *this);
     try {
         LocalReference<jobject> md = env.callObjectMethod(connection, Globals::methodConnectionGetMetaData, nullptr);
         if (!md) {
@@ -361,6 +723,7 @@ QoreValue QoreJdbcConnection::getServerVersion(ExceptionSink* xsink) {
 QoreValue QoreJdbcConnection::getClientVersion(ExceptionSink* xsink) {
     assert(connection);
     Env env;
+    BusyHelper busy(*env, *this);
     try {
         LocalReference<jobject> md = env.callObjectMethod(connection, Globals::methodConnectionGetMetaData, nullptr);
         if (!md) {
@@ -398,6 +761,7 @@ QoreValue QoreJdbcConnection::getClientVersion(ExceptionSink* xsink) {
 QoreStringNode* QoreJdbcConnection::getDriverRealName(ExceptionSink* xsink) {
     assert(connection);
     Env env;
+    BusyHelper busy(*env, *this);
     try {
         LocalReference<jobject> md = env.callObjectMethod(connection, Globals::methodConnectionGetMetaData, nullptr);
         if (!md) {
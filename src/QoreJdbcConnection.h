@@ -28,20 +28,23 @@
 #include <qore/Qore.h>
 
 #include "GlobalReference.h"
+#include "QoreJdbcColumn.h"
 #include "QoreJniClassMap.h"
 #include "JavaToQore.h"
 
+#include <atomic>
 #include <string>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace jni {
 
-#if 0
 //! Known DB types
 enum DbType {
     DBT_UNKNOWN = 0,
     DBT_ORACLE,
 };
-#endif
 
 class QoreJdbcConnection {
 public:
@@ -137,19 +140,119 @@ public:
         return numeric;
     }
 
-#if 0
+    //! Returns the maximum number of rows retrieved from Java in a single call for column-oriented fetches
+    DLLLOCAL int getFetchBlockSize() const {
+        return fetch_block_size;
+    }
+
+    //! Returns the maximum number of row blocks read in advance for SQLStatement fetches; 0 = disabled
+    DLLLOCAL int getPrefetchBlocks() const {
+        return prefetch_blocks;
+    }
+
+    //! Returns true if BLOB and CLOB values are returned as org.qore.jni.JdbcLobStream objects
+    DLLLOCAL bool getLobStreams() const {
+        return lob_streams;
+    }
+
+    //! Returns the minimum size of binary values bound as streams; 0 = disabled
+    DLLLOCAL int getStreamBindSize() const {
+        return stream_bind_size;
+    }
+
+    //! Returns the fetch size hint applied to statements when they are prepared; 0 = driver default
+    DLLLOCAL int getFetchSize() const {
+        return fetch_size;
+    }
+
+    //! Returns the number of rows after which array binds are executed as a sub-batch; 0 = one batch
+    DLLLOCAL int getBatchSize() const {
+        return batch_size;
+    }
+
+    //! Returns true if the connection must be validated after the given SQLException
+    /** data, constraint, syntax, and transaction errors do not require validation; connection errors always do;
+        otherwise the connection is validated unless it was known to be valid within the validation interval
+    */
+    DLLLOCAL bool needsValidation(Env& env, jthrowable ex);
+
+    //! Validates the connection with Connection.isValid(); updates the validation timestamp if valid
+    DLLLOCAL bool validate(Env& env);
+
+    //! Records that the connection has just been used successfully
+    DLLLOCAL void setValidated() {
+        if (validation_interval) {
+            last_validated = q_clock_getmicros();
+        }
+    }
+
+    //! Registers a statement's background result set reader (org.qore.jni.JdbcRowPrefetcher)
+    /** the connection is marked as busy while any reader is registered; does not throw C++ exceptions
+    */
+    DLLLOCAL void addPrefetcher(JNIEnv* env, jobject prefetcher);
+
+    //! Removes a background result set reader registered with addPrefetcher(); does not throw C++ exceptions
+    DLLLOCAL void removePrefetcher(JNIEnv* env, jobject prefetcher);
+
+    //! Stops all background result set readers except the given one before the connection is used
+    /** JDBC connections are not safe for concurrent use; stopped readers continue when their statement needs the
+        next block.  Does not throw C++ exceptions
+    */
+    DLLLOCAL void stopPrefetchers(JNIEnv* env, jobject except = nullptr);
+
+    //! Returns true if the background keepalive thread found the connection to be invalid; does not call Java
+    DLLLOCAL bool isKnownInvalid() const {
+        return keepalive_invalid.load(std::memory_order_acquire);
+    }
+
+    //! Returns a prepared statement for the given SQL from the statement cache or prepares a new one
+    /** the current fetch size hint is applied to the statement
+
+        @param env the JNI environment
+        @param sql the SQL string after parsing
+        @param gen returns the connection generation for the statement, must be passed to releaseStatement()
+        @param cvec returns the column descriptions of the statement's last result set for cached statements;
+        unchanged otherwise
+
+        @return the prepared statement; the caller owns the statement until it is returned with releaseStatement()
+    */
+    DLLLOCAL GlobalReference<jobject> acquireStatement(Env& env, const std::string& sql, unsigned& gen,
+            cvec_t& cvec);
+
+    //! Returns a prepared statement to the statement cache or closes it if it cannot be cached
+    /** does not throw C++ exceptions
+
+        @param env the JNI environment
+        @param sql the SQL string used to prepare the statement
+        @param gen the connection generation returned by acquireStatement()
+        @param batch true if the statement was used for batch execution
+        @param stmt the statement; set to nullptr on exit
+        @param cvec the column descriptions of the statement's last result set; moved to the cache with the
+        statement
+    */
+    DLLLOCAL void releaseStatement(JNIEnv* env, const std::string& sql, unsigned gen, bool batch,
+            GlobalReference<jobject>& stmt, cvec_t& cvec);
+
     DLLLOCAL DbType getDbType() const {
         return dbtype;
     }
 
+    //! Returns true if the jdbc driver supports Connection.createArrayOf()
+    /** the result is determined on the first call and cached
+    */
     DLLLOCAL bool areArraysSupported(Env& env);
 
-    DLLLOCAL jmethodID getOracleCreateArrayOfMethod() const {
-        assert(dbtype == DBT_ORACLE);
-        assert(methodOracleConnectionCreateOracleArray);
-        return methodOracleConnectionCreateOracleArray;
-    }
-#endif
+    //! Creates a SQL array from the given elements
+    /** uses OracleConnection.createOracleArray() with Oracle, where \a type must be the name of a collection type,
+        otherwise uses Connection.createArrayOf(), where \a type is the SQL name of the element type
+
+        @param env the JNI environment
+        @param type the array type name
+        @param elements the array elements
+
+        @return the java.sql.Array object
+    */
+    DLLLOCAL LocalReference<jobject> createArray(Env& env, const char* type, jobjectArray elements);
 
 private:
     //! Qore Program context
@@ -172,7 +275,72 @@ private:
     //! Option for numeric values
     NumericOption numeric = ENO_OPTIMAL;
 
-#if 0
+    //! Cached prepared statement with the column descriptions of its last result set
+    struct CachedStatement {
+        GlobalReference<jobject> stmt;
+        cvec_t cvec;
+    };
+    //! Cached prepared statement entry: SQL and statement
+    typedef std::pair<std::string, CachedStatement> stmt_cache_entry_t;
+    //! Cached prepared statements in LRU order; the most-recently-used statement is at the front
+    typedef std::list<stmt_cache_entry_t> stmt_cache_list_t;
+    //! Cached prepared statement index
+    typedef std::unordered_map<std::string, stmt_cache_list_t::iterator> stmt_cache_map_t;
+
+    //! Prepared statement cache
+    stmt_cache_list_t stmt_cache;
+    //! Prepared statement cache index
+    stmt_cache_map_t stmt_cache_map;
+    //! Maximum number of rows retrieved in a single block for column-oriented fetches; <= 1 = row by row
+    int fetch_block_size = 1000;
+
+    //! Maximum number of row blocks read in advance in a background thread for SQLStatement fetches; 0 = disabled
+    int prefetch_blocks = 0;
+
+    //! Return BLOB and CLOB values as streams
+    bool lob_streams = false;
+
+    //! Binary values of at least this size in bytes are bound as streams; 0 = disabled
+    int stream_bind_size = 1024 * 1024;
+
+    //! Fetch size hint applied to statements when they are prepared; 0 = use the driver's default
+    int fetch_size = 0;
+
+    //! Number of rows after which array binds are executed as a sub-batch; 0 = execute all rows in one batch
+    int batch_size = 0;
+
+    //! Time in milliseconds during which a connection known to be valid is not validated after errors; 0 = always
+    int validation_interval = 0;
+
+    //! Time the connection was last known to be valid (from q_clock_getmicros())
+    int64 last_validated = 0;
+
+    //! Idle time in milliseconds after which the connection is validated in the background; 0 = disabled
+    int keepalive_interval = 0;
+
+    //! Background connection validation (org.qore.jni.JdbcKeepalive), if enabled
+    GlobalReference<jobject> keepalive;
+
+    //! Set by the keepalive thread through a native call when the connection is found to be invalid
+    std::atomic<bool> keepalive_invalid = {false};
+
+    //! Number of statements and operations currently using the connection; the connection is not validated in the
+    //! background while it is busy
+    unsigned busy_count = 0;
+
+    //! Background result set readers of statements on this connection; owned by the statements
+    std::vector<jobject> prefetchers;
+
+    //! Maximum number of statements in the cache; 0 = disabled
+    size_t stmt_cache_size = 0;
+    //! Statement cache hits
+    int64 stmt_cache_hits = 0;
+    //! Statement cache misses
+    int64 stmt_cache_misses = 0;
+    //! Connection generation; incremented on every new connection so that statements from a lost connection are
+    //! not cached
+    unsigned conn_gen = 0;
+
     //! DB type
     DbType dbtype = DBT_UNKNOWN;
 
@@ -191,10 +359,59 @@ private:
 
     //! Mutex for atomic operations
     QoreThreadLock m;
-#endif
 
     DLLLOCAL int connect(Env& env, ExceptionSink* xsink);
 
+    //! Returns a cached or new prepared statement for acquireStatement()
+    DLLLOCAL GlobalReference<jobject> acquireStatementIntern(Env& env, const std::string& sql, cvec_t& cvec);
+
+    //! Starts background validation of the connection
+    DLLLOCAL void startKeepalive(Env& env);
+
+    //! Stops background validation of the connection; does not throw C++ exceptions
+    DLLLOCAL void stopKeepalive(JNIEnv* env);
+
+    //! Marks the connection as busy or idle for background validation; does not throw C++ exceptions
+    DLLLOCAL void setKeepaliveBusy(JNIEnv* env, bool busy);
+
+    //! Registers a user of the connection; the first user marks the connection as busy
+    DLLLOCAL void enterBusy(JNIEnv* env) {
+        if (!busy_count++) {
+            setKeepaliveBusy(env, true);
+        }
+    }
+
+    //! Releases a user of the connection; the last user marks the connection as idle
+    DLLLOCAL void exitBusy(JNIEnv* env) {
+        assert(busy_count);
+        if (!--busy_count) {
+            setKeepaliveBusy(env, false);
+        }
+    }
+
+    //! Marks the connection as busy for background validation and stops background readers while in scope
+    class BusyHelper {
+    public:
+        DLLLOCAL BusyHelper(JNIEnv* env, QoreJdbcConnection& conn) : env(env), conn(conn) {
+            conn.enterBusy(env);
+            conn.stopPrefetchers(env);
+        }
+
+        DLLLOCAL ~BusyHelper() {
+            conn.exitBusy(env);
+        }
+
+    private:
+        JNIEnv* env;
+        QoreJdbcConnection& conn;
+    };
+
+    //! Closes all cached statements; does not throw C++ exceptions
+    DLLLOCAL void clearStatementCache(JNIEnv* env);
+
+    //! Removes least-recently-used statements until the cache has at most the given number of statements
+    DLLLOCAL void trimStatementCache(JNIEnv* env, size_t size);
+
     //! Parse options passed through the Datasource
     /** @param xsink exception sink
 
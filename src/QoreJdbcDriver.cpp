@@ -345,6 +345,30 @@ void setup_jdbc_driver() {
         "'string-numbers' and 'optimal-numbers'");
     methods.registerOption(JDBC_OPT_CLASSPATH, "set the classpath before loading the driver", stringTypeInfo);
     methods.registerOption(JDBC_OPT_URL, "override the database string with the jdbc driver URL", stringTypeInfo);
+    methods.registerOption(JDBC_OPT_STMT_CACHE_SIZE, "the maximum number of prepared statements cached per "
+        "connection for reuse when the same SQL is executed again; 0 (the default) disables the cache",
+        bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_FETCH_SIZE, "the JDBC fetch size hint (the number of rows retrieved from the "
+        "server at a time) applied to statements when they are prepared; 0 (the default) means use the jdbc "
+        "driver's default", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_BATCH_SIZE, "the number of rows after which array binds are executed as a "
+        "sub-batch; 0 (the default) means execute all rows in a single batch", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_FETCH_BLOCK_SIZE, "the maximum number of rows retrieved from Java in a single "
+        "call for column-oriented fetches (select() and fetchColumns()); 0 or 1 means fetch row by row; the default "
+        "is 1000", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_PREFETCH_BLOCKS, "the maximum number of row blocks read in advance by a "
+        "background thread for SQLStatement fetches; 0 (the default) disables prefetching", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_VALIDATION_INTERVAL, "the time in milliseconds after a successful validation "
+        "or statement execution during which the connection is not validated again after an error; 0 (the default) "
+        "means always validate", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_KEEPALIVE_INTERVAL, "the idle time in milliseconds after which the connection "
+        "is validated in a background thread; 0 (the default) disables background validation", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_LOB_STREAMS, "when set, BLOB and CLOB values are returned as "
+        "org.qore.jni.JdbcLobStream objects that read the value in chunks", boolTypeInfo);
+    methods.registerOption(JDBC_OPT_STREAM_BIND_SIZE, "binary values of at least this size in bytes are bound as "
+        "streams without copying them to Java; 0 disables stream binds; the default is 1048576", bigIntTypeInfo);
+    methods.registerOption(JDBC_OPT_STMT_CACHE_STATS, "a read-only option returning a hash of prepared statement "
+        "cache statistics with the following keys: 'size', 'count', 'hits', and 'misses'", hashTypeInfo);
 
     DBID_JDBC = DBI.registerDriver("jdbc", methods, jdbc_caps);
 }
@@ -29,6 +29,16 @@
 
 constexpr const char* JDBC_OPT_CLASSPATH = "classpath";
 constexpr const char* JDBC_OPT_URL = "url";
+constexpr const char* JDBC_OPT_STMT_CACHE_SIZE = "statement-cache-size";
+constexpr const char* JDBC_OPT_STMT_CACHE_STATS = "statement-cache-stats";
+constexpr const char* JDBC_OPT_FETCH_BLOCK_SIZE = "fetch-block-size";
+constexpr const char* JDBC_OPT_FETCH_SIZE = "fetch-size";
+constexpr const char* JDBC_OPT_BATCH_SIZE = "batch-size";
+constexpr const char* JDBC_OPT_PREFETCH_BLOCKS = "prefetch-blocks";
+constexpr const char* JDBC_OPT_VALIDATION_INTERVAL = "validation-interval";
+constexpr const char* JDBC_OPT_KEEPALIVE_INTERVAL = "keepalive-interval";
+constexpr const char* JDBC_OPT_LOB_STREAMS = "lob-streams";
+constexpr const char* JDBC_OPT_STREAM_BIND_SIZE = "stream-bind-size";
 
 namespace jni {
 DLLLOCAL void setup_jdbc_driver();
@@ -64,14 +64,22 @@ int QoreJdbcPreparedStatement::prepare(const QoreString& qstr, const QoreListNod
 int QoreJdbcPreparedStatement::exec(ExceptionSink* xsink) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
         if (bindQueryArguments(env, xsink)) {
             assert(*xsink);
             return -1;
         }
 
-        if (execIntern(env, sql, xsink)
-            && (acquireResultSet(env, xsink) || describeResultSet(env, xsink))) {
+        if (execIntern(env, sql, xsink)) {
+            if (acquireResultSet(env, xsink) || describeResultSet(env, xsink)) {
                 return -1;
+            }
+            // read the result set in the background if configured
+            int queue_size = conn->getPrefetchBlocks();
+            int block_size = conn->getFetchBlockSize();
+            if (queue_size > 0 && block_size > 1) {
+                startPrefetch(env, block_size, queue_size);
+            }
         }
         return *xsink ? -1 : 0;
     } catch (JavaException& e) {
@@ -94,6 +102,10 @@ QoreHashNode* QoreJdbcPreparedStatement::getOutputHash(ExceptionSink* xsink, boo
         int max_rows) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
+        if (isPrefetching()) {
+            return getPrefetchOutputHash(env, xsink, empty_hash_if_nothing, max_rows);
+        }
         return getOutputHashIntern(env, xsink, empty_hash_if_nothing, max_rows);
     } catch (JavaException& e) {
         e.convert(xsink);
@@ -104,6 +116,10 @@ QoreHashNode* QoreJdbcPreparedStatement::getOutputHash(ExceptionSink* xsink, boo
 QoreHashNode* QoreJdbcPreparedStatement::fetchRow(ExceptionSink* xsink) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
+        if (isPrefetching()) {
+            return getPrefetchRow(xsink);
+        }
         return getSingleRowIntern(env, xsink);
     } catch (JavaException& e) {
         e.convert(xsink);
@@ -114,6 +130,10 @@ QoreHashNode* QoreJdbcPreparedStatement::fetchRow(ExceptionSink* xsink) {
 QoreListNode* QoreJdbcPreparedStatement::fetchRows(int max_rows, ExceptionSink* xsink) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
+        if (isPrefetching()) {
+            return getPrefetchOutputList(env, xsink, max_rows);
+        }
         return getOutputListIntern(env, xsink, max_rows);
     } catch (JavaException& e) {
         e.convert(xsink);
@@ -124,6 +144,10 @@ QoreListNode* QoreJdbcPreparedStatement::fetchRows(int max_rows, ExceptionSink*
 QoreHashNode* QoreJdbcPreparedStatement::fetchColumns(int max_rows, ExceptionSink* xsink) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
+        if (isPrefetching()) {
+            return getPrefetchOutputHash(env, xsink, true, max_rows);
+        }
         return getOutputHashIntern(env, xsink, true, max_rows);
     } catch (JavaException& e) {
         e.convert(xsink);
@@ -134,6 +158,10 @@ QoreHashNode* QoreJdbcPreparedStatement::fetchColumns(int max_rows, ExceptionSin
 bool QoreJdbcPreparedStatement::next(ExceptionSink* xsink) {
     try {
         Env env;
+        stopOtherPrefetchers(env);
+        if (isPrefetching()) {
+            return prefetchNext(env, xsink);
+        }
         return QoreJdbcStatement::next(env);
     } catch (JavaException& e) {
         e.convert(xsink);
@@ -25,13 +25,52 @@
 #include "Globals.h"
 #include "QoreToJava.h"
 #include "JavaToQore.h"
+#include "Array.h"
 
 #include <set>
+#include <algorithm>
 
 namespace jni {
 
-QoreJdbcColumn::QoreJdbcColumn(std::string&& name, std::string&& qname, jint ctype) : name(name), qname(qname),
-        strip(ctype == Globals::typeChar) {
+QoreJdbcColumn::QoreJdbcColumn(std::string&& name, std::string&& qname, jint ctype, bool is_signed,
+        bool lob_streams) : name(name), qname(qname), ctype(ctype), strip(ctype == Globals::typeChar),
+        fetch_type(getFetchType(ctype, is_signed, lob_streams)) {
+}
+
+JdbcFetchType QoreJdbcColumn::getFetchType(jint ctype, bool is_signed, bool lob_streams) {
+    // java.sql.Types values are not compile-time constants here, so a switch cannot be used
+    if (ctype == Globals::typeInteger || ctype == Globals::typeSmallInt || ctype == Globals::typeTinyInt) {
+        return JFT_LONG;
+    }
+    // unsigned BIGINT values may not fit in a long
+    if (ctype == Globals::typeBigInt) {
+        return is_signed ? JFT_LONG : JFT_OBJECT;
+    }
+    if (ctype == Globals::typeDouble || ctype == Globals::typeFloat || ctype == Globals::typeReal) {
+        return JFT_DOUBLE;
+    }
+    if (ctype == Globals::typeBoolean) {
+        return JFT_BOOLEAN;
+    }
+    if (ctype == Globals::typeChar || ctype == Globals::typeVarchar || ctype == Globals::typeLongVarchar
+        || ctype == Globals::typeNChar || ctype == Globals::typeNVarchar || ctype == Globals::typeLongNVarchar) {
+        return JFT_STRING;
+    }
+    if (ctype == Globals::typeBinary || ctype == Globals::typeVarBinary || ctype == Globals::typeLongVarBinary) {
+        return JFT_BYTES;
+    }
+    if (ctype == Globals::typeTimestamp) {
+        return JFT_TIMESTAMP;
+    }
+    if (lob_streams) {
+        if (ctype == Globals::typeBlob) {
+            return JFT_BLOB;
+        }
+        if (ctype == Globals::typeClob || ctype == Globals::typeNClob) {
+            return JFT_CLOB;
+        }
+    }
+    return JFT_OBJECT;
 }
 
 QoreJdbcStatement::~QoreJdbcStatement() {
@@ -67,15 +106,14 @@ void QoreJdbcStatement::prepareAndBindStatement(Env& env, ExceptionSink* xsink,
 void QoreJdbcStatement::prepareStatement(Env& env, const QoreString& str) {
     assert(!stmt);
     // no exception handling needed; calls must be wrapped in a try/catch block
-    std::vector<jvalue> jargs(1);
-    LocalReference<jstring> jstr = env.newString(str.c_str());
-    jargs[0].l = jstr;
-
-    stmt = env.callObjectMethod(conn->getConnectionObject(), Globals::methodConnectionPrepareStatement, &jargs[0])
-        .makeGlobal();
+    stmt_sql.assign(str.c_str(), str.size());
+    stmt = conn->acquireStatement(env, stmt_sql, stmt_gen, cvec);
 }
 
 int QoreJdbcStatement::bindQueryArguments(Env& env, ExceptionSink* xsink) {
+    input_stream_bound = false;
+    batch_binder = nullptr;
+    batch_rows = 0;
     if (hasArrayBind()) {
         if (bindInternArray(env, *params, xsink)) {
             return -1;
@@ -87,37 +125,62 @@ int QoreJdbcStatement::bindQueryArguments(Env& env, ExceptionSink* xsink) {
 }
 
 bool QoreJdbcStatement::execIntern(Env& env, const QoreString& qstr, ExceptionSink* xsink) {
-    do {
+    // bound streams must not be read after the statement has been executed
+    ON_BLOCK_EXIT_OBJ(*this, &QoreJdbcStatement::detachBindStreams, *env);
+
+    // reconnect immediately if the connection was found to be invalid while idle
+    if (conn->isKnownInvalid()) {
+        printd(5, "QoreJdbcStatement::execIntern() connection invalid; reconnecting\n");
+        if (reconnectLostConnection(env, xsink)) {
+            return false;
+        }
+        prepareAndBindStatement(env, xsink, qstr);
+        if (*xsink) {
+            return false;
+        }
+    }
+
+    // the statement is executed again at most once after a reconnection
+    bool retry = true;
+    while (true) {
         // check for a lost connection
         try {
+            bool rc;
             if (do_batch_execute) {
-                // ignore return value
-                env.callObjectMethod(stmt, Globals::methodPreparedStatementExecuteBatch, nullptr);
-                return false;
+                // staged rows are bound here, so that all sub-batches are executed with the same error handling
+                if (executeBatchRows(env, xsink)) {
+                    return false;
+                }
+                rc = false;
+            } else {
+                rc = env.callBooleanMethod(stmt, Globals::methodPreparedStatementExecute, nullptr);
             }
-            return env.callBooleanMethod(stmt, Globals::methodPreparedStatementExecute, nullptr);
+            conn->setValidated();
+            return rc;
         } catch (JavaException& e) {
             LocalReference<jthrowable> throwable = e.save();
             assert(throwable);
-            if (env.isInstanceOf(throwable, Globals::classSQLException)) {
-                // check if connection is still valid; 1 second timeout
-                jvalue jarg;
-                jarg.i = 1;
-                bool connected = env.callBooleanMethod(conn->getConnectionObject(), Globals::methodConnectionIsValid,
-                    &jarg);
+            // only validate the connection if the error could have been caused by a lost connection; statements
+            // with bound input streams cannot be executed again, as the failed execution may have read the streams
+            if (retry && !input_stream_bound && env.isInstanceOf(throwable, Globals::classSQLException)
+                && conn->needsValidation(env, throwable)) {
+                bool connected = conn->validate(env);
                 //printd(5, "QoreJdbcStatement::execIntern() connected: %d\n", connected);
                 if (!connected && !reconnectLostConnection(env, xsink)) {
                     assert(!*xsink);
                     // repeat statement execution after reconnection when not in a transaction
                     prepareAndBindStatement(env, xsink, qstr);
+                    if (*xsink) {
+                        return false;
+                    }
+                    retry = false;
                     continue;
                 }
             }
             e.restore(throwable.release());
             throw;
         }
-    } while (false);
-    return false;
+    }
 }
 
 void QoreJdbcStatement::close(Env& env_obj) {
@@ -125,13 +188,25 @@ void QoreJdbcStatement::close(Env& env_obj) {
     JNIEnv* env = *env_obj;
     bool active_java_exception = env->ExceptionCheck();
 
+    detachBindStreams(env);
+    if (prefetcher) {
+        // stop the background reader before the result set is closed
+        env->CallVoidMethodA(prefetcher, Globals::methodJdbcRowPrefetcherClose, nullptr);
+        conn->removePrefetcher(env, prefetcher);
+        prefetcher = nullptr;
+        ExceptionSink xsink;
+        clearPrefetchBlock(&xsink);
+    }
+    // closing the result set and the statement uses the connection
+    conn->stopPrefetchers(env);
+    block_fetcher = nullptr;
     if (rs) {
         env->CallVoidMethodA(rs, Globals::methodResultSetClose, nullptr);
         rs = nullptr;
     }
     if (stmt) {
-        env->CallVoidMethodA(stmt, Globals::methodPreparedStatementClose, nullptr);
-        stmt = nullptr;
+        // returns the statement to the connection's statement cache or closes it
+        conn->releaseStatement(env, stmt_sql, stmt_gen, do_batch_execute, stmt, cvec);
     }
     if (!active_java_exception && env->ExceptionCheck()) {
         throw new JavaException;
@@ -144,6 +219,8 @@ void QoreJdbcStatement::reset(Env& env) {
     bind_size = 0;
     array_bind_size = 0;
     do_batch_execute = false;
+    batch_binder = nullptr;
+    batch_rows = 0;
     params = nullptr;
     cvec.clear();
 }
@@ -186,8 +263,45 @@ int QoreJdbcStatement::reconnectLostConnection(Env& env, ExceptionSink* xsink) {
     return 0;
 }
 
+bool QoreJdbcStatement::checkCachedColumns(Env& env) {
+    assert(rs);
+    assert(!cvec.empty());
+    jvalue jarg;
+    jarg.l = rs;
+    LocalReference<jintArray> jtypes = env.callStaticObjectMethod(Globals::classJdbcBlockFetcher,
+        Globals::methodJdbcBlockFetcherGetColumnTypes, &jarg).as<jintArray>();
+    jsize count = env.getArrayLength(jtypes);
+    if ((size_t)count != cvec.size()) {
+        return false;
+    }
+    std::vector<jint> types(count);
+    env.getIntArrayRegion(jtypes, 0, count, &types[0]);
+    bool lob_streams = conn->getLobStreams();
+    for (jsize i = 0; i < count; ++i) {
+        if (types[i] != cvec[i].ctype) {
+            return false;
+        }
+        // the fetch strategy for LOB columns depends on the "lob-streams" option
+        bool lob_stream = cvec[i].fetch_type == JFT_BLOB || cvec[i].fetch_type == JFT_CLOB;
+        if (lob_stream != (lob_streams && (types[i] == Globals::typeBlob || types[i] == Globals::typeClob
+            || types[i] == Globals::typeNClob))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int QoreJdbcStatement::describeResultSet(Env& env, ExceptionSink* xsink) {
     assert(rs);
+    // reuse the column descriptions from the previous execution of the statement if the column types match
+    if (!cvec.empty()) {
+        if (checkCachedColumns(env)) {
+            return 0;
+        }
+        printd(5, "QoreJdbcStatement::describeResultSet() this: %p result set columns changed; describing again\n",
+            this);
+        cvec.clear();
+    }
     LocalReference<jobject> info = env.callObjectMethod(rs, Globals::methodResultSetGetMetaData,
         nullptr);
     assert(info);
@@ -239,7 +353,11 @@ int QoreJdbcStatement::describeResultSet(Env& env, ExceptionSink* xsink) {
 
         // get column type
         jint ctype = env.callIntMethod(info, Globals::methodResultSetMetaDataGetColumnType, &jarg);
-        cvec.emplace_back(QoreJdbcColumn(qname.c_str(), std::move(unique_qname), ctype));
+        bool is_signed = ctype == Globals::typeBigInt
+            ? env.callBooleanMethod(info, Globals::methodResultSetMetaDataIsSigned, &jarg)
+            : true;
+        cvec.emplace_back(QoreJdbcColumn(qname.c_str(), std::move(unique_qname), ctype, is_signed,
+            conn->getLobStreams()));
     }
 
     return 0;
@@ -302,6 +420,11 @@ public:
         return l;
     }
 
+    //! Exchanges the column lists with the given vector
+    DLLLOCAL void swap(lvec_t& other) {
+        l.swap(other);
+    }
+
     DLLLOCAL QoreHashNode* getHash() {
         ReferenceHolder<QoreHashNode> rv(new QoreHashNode(autoTypeInfo), xsink);
         if (!l.empty()) {
@@ -325,9 +448,74 @@ QoreHashNode* QoreJdbcStatement::getOutputHashIntern(Env& env, ExceptionSink* xs
     QoreListArray l(xsink, cvec);
 
     size_t row_count = 0;
+    int block_size = conn->getFetchBlockSize();
+    if (block_size > 1) {
+        if (getOutputHashBlockIntern(env, l, row_count, block_size, max_rows, xsink)) {
+            return nullptr;
+        }
+    } else {
+        while (true) {
+            // get next row
+            if (!next(env)) {
+                break;
+            }
+
+            if (!row_count) {
+                l.populate();
+            }
+
+            //! get column data
+            for (jint c = 0, e = (jint)cvec.size(); c < e; ++c) {
+                QoreJdbcColumn& col = cvec[c];
+                ValueHolder val(getColumnValue(env, c + 1, col, xsink), xsink);
+                if (*xsink) {
+                    return nullptr;
+                }
+
+                l.get()[c]->push(val.release(), xsink);
+                assert(!*xsink);
+            }
+            ++row_count;
+            if (max_rows > 0 && row_count == (size_t)max_rows) {
+                break;
+            }
+        }
+    }
+
+    if (!row_count && !empty_hash_if_nothing) {
+        l.populate();
+    }
+    return l.getHash();
+}
+
+int QoreJdbcStatement::getOutputHashBlockIntern(Env& env, QoreListArray& l, size_t& row_count, int block_size,
+        int max_rows, ExceptionSink* xsink) {
+    // create the Java fetcher with the fetch strategy for each column once for each result set, so that the column
+    // arrays are not allocated again when the result set is retrieved in several calls
+    if (!block_fetcher || block_fetcher_size != block_size) {
+        LocalReference<jintArray> jtypes = getFetchTypes(env);
+        std::vector<jvalue> jargs(3);
+        jargs[0].l = rs;
+        jargs[1].l = jtypes;
+        jargs[2].i = block_size;
+        block_fetcher = env.newObject(Globals::classJdbcBlockFetcher, Globals::ctorJdbcBlockFetcher, &jargs[0]);
+        block_fetcher_size = block_size;
+    }
+    jobject fetcher = block_fetcher;
+
     while (true) {
-        // get next row
-        if (!next(env)) {
+        // never read more rows than requested so that the result set can be used for the next fetch
+        jint req = block_size;
+        if (max_rows > 0 && (size_t)(max_rows - row_count) < (size_t)req) {
+            req = (jint)(max_rows - row_count);
+            if (!req) {
+                break;
+            }
+        }
+        jvalue jarg;
+        jarg.i = req;
+        jint rows = env.callIntMethod(fetcher, Globals::methodJdbcBlockFetcherFetch, &jarg);
+        if (!rows) {
             break;
         }
 
@@ -335,18 +523,217 @@ QoreHashNode* QoreJdbcStatement::getOutputHashIntern(Env& env, ExceptionSink* xs
             l.populate();
         }
 
-        //! get column data
-        for (jint c = 0, e = (jint)cvec.size(); c < e; ++c) {
-            QoreJdbcColumn& col = cvec[c];
-            ValueHolder val(getColumnValue(env, c + 1, col, xsink), xsink);
-            if (*xsink) {
-                return nullptr;
+        if (convertBlock(env, fetcher, rows, l, xsink)) {
+            return -1;
+        }
+        row_count += rows;
+
+        // a short block means that the result set has been exhausted
+        if (rows < req) {
+            break;
+        }
+    }
+
+    return 0;
+}
+
+LocalReference<jintArray> QoreJdbcStatement::getFetchTypes(Env& env) const {
+    jint cols = (jint)cvec.size();
+    LocalReference<jintArray> jtypes = env.newIntArray(cols);
+    std::vector<jint> types;
+    types.reserve(cols);
+    for (auto& i : cvec) {
+        types.push_back(i.fetch_type);
+    }
+    env.setIntArrayRegion(jtypes, 0, cols, &types[0]);
+    return jtypes;
+}
+
+int QoreJdbcStatement::convertBlock(Env& env, jobject fetcher, jint rows, QoreListArray& l, ExceptionSink* xsink) {
+    jint cols = (jint)cvec.size();
+
+    // buffers for primitive column values
+    std::vector<jlong> lbuf;
+    std::vector<jdouble> dbuf;
+    std::vector<jboolean> nbuf;
+
+    jvalue jarg;
+    for (jint c = 0; c < cols; ++c) {
+        QoreJdbcColumn& col = cvec[c];
+        QoreListNode* list = l.get()[c];
+        jarg.i = c;
+
+        switch (col.fetch_type) {
+            case JFT_LONG:
+            case JFT_BOOLEAN: {
+                LocalReference<jobject> nulls = env.callObjectMethod(fetcher,
+                    Globals::methodJdbcBlockFetcherGetNulls, &jarg);
+                LocalReference<jobject> vals = env.callObjectMethod(fetcher,
+                    Globals::methodJdbcBlockFetcherGetLongs, &jarg);
+                nbuf.resize(rows);
+                lbuf.resize(rows);
+                env.getBooleanArrayRegion(nulls.cast<jbooleanArray>(), 0, rows, &nbuf[0]);
+                env.getLongArrayRegion(vals.cast<jlongArray>(), 0, rows, &lbuf[0]);
+                for (jint r = 0; r < rows; ++r) {
+                    if (nbuf[r]) {
+                        list->push(&Null, xsink);
+                    } else if (col.fetch_type == JFT_BOOLEAN) {
+                        list->push((bool)lbuf[r], xsink);
+                    } else {
+                        list->push((int64)lbuf[r], xsink);
+                    }
+                }
+                break;
             }
 
-            l.get()[c]->push(val.release(), xsink);
-            assert(!*xsink);
+            case JFT_DOUBLE: {
+                LocalReference<jobject> nulls = env.callObjectMethod(fetcher,
+                    Globals::methodJdbcBlockFetcherGetNulls, &jarg);
+                LocalReference<jobject> vals = env.callObjectMethod(fetcher,
+                    Globals::methodJdbcBlockFetcherGetDoubles, &jarg);
+                nbuf.resize(rows);
+                dbuf.resize(rows);
+                env.getBooleanArrayRegion(nulls.cast<jbooleanArray>(), 0, rows, &nbuf[0]);
+                env.getDoubleArrayRegion(vals.cast<jdoubleArray>(), 0, rows, &dbuf[0]);
+                for (jint r = 0; r < rows; ++r) {
+                    if (nbuf[r]) {
+                        list->push(&Null, xsink);
+                    } else {
+                        list->push((double)dbuf[r], xsink);
+                    }
+                }
+                break;
+            }
+
+            default: {
+                LocalReference<jobject> vals = env.callObjectMethod(fetcher,
+                    Globals::methodJdbcBlockFetcherGetObjects, &jarg);
+                jobjectArray array = vals.cast<jobjectArray>();
+                for (jint r = 0; r < rows; ++r) {
+                    LocalReference<jobject> val = env.getObjectArrayElement(array, r);
+                    if (!val) {
+                        list->push(&Null, xsink);
+                        continue;
+                    }
+                    ValueHolder v(convertColumnObject(env, val, col, xsink), xsink);
+                    if (*xsink) {
+                        return -1;
+                    }
+                    list->push(v.release(), xsink);
+                }
+                break;
+            }
         }
+        assert(!*xsink);
+    }
+
+    return 0;
+}
+
+void QoreJdbcStatement::startPrefetch(Env& env, int block_size, int queue_size) {
+    assert(rs);
+    assert(!prefetcher);
+    LocalReference<jintArray> jtypes = getFetchTypes(env);
+    std::vector<jvalue> jargs(4);
+    jargs[0].l = rs;
+    jargs[1].l = jtypes;
+    jargs[2].i = block_size;
+    jargs[3].i = queue_size;
+    prefetcher = env.newObject(Globals::classJdbcRowPrefetcher, Globals::ctorJdbcRowPrefetcher, &jargs[0])
+        .makeGlobal();
+    conn->addPrefetcher(*env, prefetcher);
+    printd(5, "QoreJdbcStatement::startPrefetch() this: %p block size: %d queue size: %d\n", this, block_size,
+        queue_size);
+}
+
+void QoreJdbcStatement::clearPrefetchBlock(ExceptionSink* xsink) {
+    for (auto& i : prefetch_block) {
+        i->deref(xsink);
+    }
+    prefetch_block.clear();
+    prefetch_rows = 0;
+    prefetch_pos = 0;
+}
+
+bool QoreJdbcStatement::prefetchNext(Env& env, ExceptionSink* xsink) {
+    assert(prefetcher);
+    if (prefetch_pos < prefetch_rows) {
+        ++prefetch_pos;
+        return true;
+    }
+    clearPrefetchBlock(xsink);
+
+    // wait for the next block from the background thread
+    LocalReference<jobject> block = env.callObjectMethod(prefetcher, Globals::methodJdbcRowPrefetcherTake, nullptr);
+    if (!block) {
+        return false;
+    }
+    jint rows = env.callIntMethod(block, Globals::methodJdbcBlockFetcherGetRowCount, nullptr);
+    assert(rows > 0);
+
+    QoreListArray l(xsink, cvec);
+    l.populate();
+    if (convertBlock(env, block, rows, l, xsink)) {
+        return false;
+    }
+    l.swap(prefetch_block);
+    prefetch_rows = rows;
+    prefetch_pos = 1;
+    return true;
+}
+
+QoreHashNode* QoreJdbcStatement::getPrefetchRow(ExceptionSink* xsink) {
+    if (!prefetch_pos) {
+        xsink->raiseException("JDBC-RESULTSET-ERROR", "no current row is available; call next() before "
+            "retrieving the row");
+        return nullptr;
+    }
+    ReferenceHolder<QoreHashNode> h(new QoreHashNode(autoTypeInfo), xsink);
+    for (size_t c = 0, e = cvec.size(); c < e; ++c) {
+        h->setKeyValue(cvec[c].qname.c_str(), prefetch_block[c]->retrieveEntry(prefetch_pos - 1).refSelf(),
+            xsink);
+    }
+    return h.release();
+}
+
+QoreListNode* QoreJdbcStatement::getPrefetchOutputList(Env& env, ExceptionSink* xsink, int max_rows) {
+    ReferenceHolder<QoreListNode> l(new QoreListNode(autoTypeInfo), xsink);
+
+    int row_count = 0;
+    while (prefetchNext(env, xsink)) {
+        ReferenceHolder<QoreHashNode> h(getPrefetchRow(xsink), xsink);
+        if (!h) {
+            break;
+        }
+        l->push(h.release(), xsink);
         ++row_count;
+        if (max_rows > 0 && row_count == max_rows) {
+            break;
+        }
+    }
+
+    return *xsink ? nullptr : l.release();
+}
+
+QoreHashNode* QoreJdbcStatement::getPrefetchOutputHash(Env& env, ExceptionSink* xsink, bool empty_hash_if_nothing,
+        int max_rows) {
+    QoreListArray l(xsink, cvec);
+
+    int row_count = 0;
+    while (prefetchNext(env, xsink)) {
+        if (!row_count) {
+            l.populate();
+        }
+        for (size_t c = 0, e = cvec.size(); c < e; ++c) {
+            l.get()[c]->push(prefetch_block[c]->retrieveEntry(prefetch_pos - 1).refSelf(), xsink);
+        }
+        ++row_count;
+        if (max_rows > 0 && row_count == max_rows) {
+            break;
+        }
+    }
+    if (*xsink) {
+        return nullptr;
     }
 
     if (!row_count && !empty_hash_if_nothing) {
@@ -440,10 +827,99 @@ QoreValue QoreJdbcStatement::getColumnValue(Env& env, int column, QoreJdbcColumn
     // get column value for this row
     jvalue jarg;
     jarg.i = column;
+
+    // use the type-specific getter if possible to avoid boxing and generic conversions
+    switch (col.fetch_type) {
+        case JFT_LONG: {
+            int64 v = env.callLongMethod(rs, Globals::methodResultSetGetLong, &jarg);
+            if (env.callBooleanMethod(rs, Globals::methodResultSetWasNull, nullptr)) {
+                return &Null;
+            }
+            return v;
+        }
+
+        case JFT_DOUBLE: {
+            double v = env.callDoubleMethod(rs, Globals::methodResultSetGetDouble, &jarg);
+            if (env.callBooleanMethod(rs, Globals::methodResultSetWasNull, nullptr)) {
+                return &Null;
+            }
+            return v;
+        }
+
+        case JFT_BOOLEAN: {
+            bool v = env.callBooleanMethod(rs, Globals::methodResultSetGetBoolean, &jarg);
+            if (env.callBooleanMethod(rs, Globals::methodResultSetWasNull, nullptr)) {
+                return &Null;
+            }
+            return v;
+        }
+
+        case JFT_STRING: {
+            LocalReference<jobject> v = env.callObjectMethod(rs, Globals::methodResultSetGetString, &jarg);
+            return v ? convertColumnObject(env, v, col, xsink) : QoreValue(&Null);
+        }
+
+        case JFT_BYTES: {
+            LocalReference<jobject> v = env.callObjectMethod(rs, Globals::methodResultSetGetBytes, &jarg);
+            return v ? convertColumnObject(env, v, col, xsink) : QoreValue(&Null);
+        }
+
+        case JFT_TIMESTAMP: {
+            LocalReference<jobject> ts = env.callObjectMethod(rs, Globals::methodResultSetGetTimestamp, &jarg);
+            if (!ts) {
+                return &Null;
+            }
+            LocalReference<jobject> v = env.callObjectMethod(ts, Globals::methodTimestampToString, nullptr);
+            return convertColumnObject(env, v, col, xsink);
+        }
+
+        case JFT_BLOB:
+        case JFT_CLOB: {
+            std::vector<jvalue> jargs(4);
+            jargs[0].l = rs;
+            jargs[1].i = column;
+            jargs[2].z = col.fetch_type == JFT_CLOB;
+            jargs[3].i = 0;
+            LocalReference<jobject> v = env.callStaticObjectMethod(Globals::classJdbcLobStream,
+                Globals::methodJdbcLobStreamGet, &jargs[0]);
+            return v ? convertColumnObject(env, v, col, xsink) : QoreValue(&Null);
+        }
+
+        default:
+            break;
+    }
+
     LocalReference<jobject> val = env.callObjectMethod(rs, Globals::methodResultSetGetObject, &jarg);
-    if (!val) {
-        return &Null;
+    return val ? convertColumnObject(env, val, col, xsink) : QoreValue(&Null);
+}
+
+QoreValue QoreJdbcStatement::convertColumnObject(Env& env, LocalReference<jobject>& val, QoreJdbcColumn& col,
+        ExceptionSink* xsink) {
+    assert(val);
+    switch (col.fetch_type) {
+        case JFT_STRING: {
+            Env::GetStringUtfChars chars(env, val.cast<jstring>());
+            QoreStringNode* str = new QoreStringNode(chars.c_str(), QCS_UTF8);
+            // strip trailing spaces in CHAR columns if necessary
+            if (col.strip) {
+                str->trim_trailing(' ');
+            }
+            return str;
+        }
+
+        case JFT_BYTES:
+            return Array::getBinary(env, val.cast<jarray>()).release();
+
+        // timestamps are retrieved as strings
+        case JFT_TIMESTAMP: {
+            Env::GetStringUtfChars chars(env, val.cast<jstring>());
+            return new DateTimeNode(chars.c_str());
+        }
+
+        default:
+            break;
     }
+
     // return Qore value
     ValueHolder rv(JavaToQore::convertToQore(val.release(), conn->getProgram(), false, conn->getNumericOption()),
         xsink);
@@ -652,7 +1128,14 @@ int QoreJdbcStatement::bindParamSingleValue(Env& env, int column, QoreValue arg,
         }
 
         case NT_BINARY: {
-            LocalReference<jbyteArray> array = QoreToJava::makeByteArray(env, *arg.get<const BinaryNode>());
+            const BinaryNode* b = arg.get<const BinaryNode>();
+            // large values are streamed from the Qore value instead of being copied to a Java byte array
+            int stream_size = conn->getStreamBindSize();
+            if (stream_size && b->size() >= (size_t)stream_size) {
+                bindBinaryStream(env, column, *b);
+                break;
+            }
+            LocalReference<jbyteArray> array = QoreToJava::makeByteArray(env, *b);
             jargs[1].l = array;
             env.callVoidMethod(stmt, Globals::methodPreparedStatementSetBytes, &jargs[0]);
             break;
@@ -683,6 +1166,12 @@ int QoreJdbcStatement::bindParamSingleValue(Env& env, int column, QoreValue arg,
             break;
         }
 
+        case NT_HASH:
+            return bindTypedArray(env, column, arg.get<const QoreHashNode>(), xsink);
+
+        case NT_OBJECT:
+            return bindInputStream(env, column, arg.get<const QoreObject>(), xsink);
+
         default:
             xsink->raiseException("JDBC-BIND-ERROR", "do not know how to bind arguments of type '%s'",
                 arg.getFullTypeName());
@@ -692,6 +1181,90 @@ int QoreJdbcStatement::bindParamSingleValue(Env& env, int column, QoreValue arg,
     return 0;
 }
 
+void QoreJdbcStatement::bindBinaryStream(Env& env, int column, const BinaryNode& b) {
+    LocalReference<jobject> buf = env.newDirectByteBuffer(const_cast<void*>(b.getPtr()), (jlong)b.size());
+    jvalue jarg;
+    jarg.l = buf;
+    LocalReference<jobject> stream = env.newObject(Globals::classJdbcBindStream, Globals::ctorJdbcBindStreamBuffer,
+        &jarg);
+    bind_streams.push_back(stream.makeGlobal());
+
+    std::vector<jvalue> jargs(3);
+    jargs[0].i = column;
+    jargs[1].l = stream;
+    jargs[2].j = (jlong)b.size();
+    env.callVoidMethod(stmt, Globals::methodPreparedStatementSetBinaryStreamLength, &jargs[0]);
+}
+
+int QoreJdbcStatement::bindInputStream(Env& env, int column, const QoreObject* obj, ExceptionSink* xsink) {
+    // returns the Java object for Java objects and an org.qore.jni.QoreObject wrapper for Qore objects
+    LocalReference<jobject> jobj = qjcm.getJavaObject(obj);
+    if (!jobj) {
+        xsink->raiseException("JDBC-BIND-ERROR", "cannot bind deleted object argument %d (starting from 1)",
+            column);
+        return -1;
+    }
+
+    std::vector<jvalue> jargs(2);
+    jargs[0].i = column;
+
+    // Java InputStream objects are bound directly
+    if (env.isInstanceOf(jobj, Globals::classInputStream)) {
+        jargs[1].l = jobj;
+        env.callVoidMethod(stmt, Globals::methodPreparedStatementSetBinaryStream, &jargs[0]);
+        input_stream_bound = true;
+        return 0;
+    }
+
+    const QoreClass* qc = nullptr;
+    if (env.isInstanceOf(jobj, Globals::classQoreObject)) {
+        qc = conn->getProgram()->findClass("Qore::InputStream", xsink);
+        if (*xsink) {
+            return -1;
+        }
+    }
+    if (!qc || !obj->validInstanceOf(*qc)) {
+        xsink->raiseException("JDBC-BIND-ERROR", "cannot bind object argument %d (starting from 1) of class '%s'; "
+            "only InputStream objects can be bound", column, obj->getClassName());
+        return -1;
+    }
+
+    // Qore InputStream objects are read with InputStream::read() when the driver reads the stream
+    jvalue jarg;
+    jarg.l = jobj;
+    LocalReference<jobject> stream = env.newObject(Globals::classJdbcBindStream, Globals::ctorJdbcBindStreamObject,
+        &jarg);
+    bind_streams.push_back(stream.makeGlobal());
+
+    jargs[1].l = stream;
+    env.callVoidMethod(stmt, Globals::methodPreparedStatementSetBinaryStream, &jargs[0]);
+    input_stream_bound = true;
+    return 0;
+}
+
+void QoreJdbcStatement::detachBindStreams(JNIEnv* env) {
+    if (bind_streams.empty()) {
+        return;
+    }
+    // preserve any exception raised by the statement's execution
+    JavaExceptionRethrowHelper erh;
+    for (auto& i : bind_streams) {
+        env->CallVoidMethodA(i, Globals::methodJdbcBindStreamDetach, nullptr);
+        env->ExceptionClear();
+    }
+    bind_streams.clear();
+}
+
+// returns true if the SQL is a query (starts with "select" or "with")
+static bool is_query(const std::string& sql) {
+    size_t i = sql.find_first_not_of(" \t\r\n(");
+    if (i == std::string::npos) {
+        return false;
+    }
+    const char* p = sql.c_str() + i;
+    return (!strncasecmp(p, "select", 6) && !isalnum(p[6])) || (!strncasecmp(p, "with", 4) && !isalnum(p[4]));
+}
+
 int QoreJdbcStatement::bindInternArray(Env& env, const QoreListNode* args, ExceptionSink* xsink) {
     // Check that enough parameters were passed for binding.
     size_t count = args ? args->size() : 0;
@@ -702,59 +1275,291 @@ int QoreJdbcStatement::bindInternArray(Env& env, const QoreListNode* args, Excep
         return -1;
     }
 
-    return bindInternArrayBatch(env, args, xsink);
-#if 0
-    if (conn->areArraysSupported(env)) {
-        return bindInternArrayNative(env, args, xsink);
-    } else {
+    // SQL arrays are only used for queries; DML statements keep batch semantics with one execution per row
+    if (!is_query(stmt_sql)) {
         return bindInternArrayBatch(env, args, xsink);
     }
-#endif
+
+    // queries cannot be executed as a batch, so list arguments must be bound as SQL arrays
+    if (!conn->areArraysSupported(env)) {
+        if (conn->getDbType() == DBT_ORACLE) {
+            xsink->raiseException("JDBC-BIND-ERROR", "cannot bind list arguments to a query with Oracle without a "
+                "collection type; bind the list with a hash with '^jdbctype^' giving the name of the collection "
+                "type and '^value^' giving the list");
+        } else {
+            xsink->raiseException("JDBC-BIND-ERROR", "cannot bind list arguments to a query; the jdbc driver does "
+                "not support Connection.createArrayOf()");
+        }
+        return -1;
+    }
+
+    int rc = bindInternArrayNative(env, args, xsink);
+    if (rc > 0) {
+        xsink->raiseException("JDBC-BIND-ERROR", "cannot bind list arguments with binary values or with values of "
+            "different types to a query; bind the list with a hash with '^jdbctype^' giving the SQL element type "
+            "and '^value^' giving the list");
+        return -1;
+    }
+    return rc;
 }
 
-#if 0
-const char* QoreJdbcStatement::getArrayBindType(const QoreListNode* l) const {
-    ConstListIterator i(l);
-    while (i.next()) {
-        switch (i.getValue().getType()) {
-            case NT_NOTHING:
-            case NT_NULL:
-                break;
+static JdbcBindType get_bind_type(qore_type_t t) {
+    switch (t) {
+        case NT_NOTHING:
+        case NT_NULL:
+            return JBT_NULL;
+        case NT_INT:
+            return JBT_LONG;
+        case NT_FLOAT:
+            return JBT_DOUBLE;
+        case NT_BOOLEAN:
+            return JBT_BOOLEAN;
+        case NT_STRING:
+            return JBT_STRING;
+        case NT_BINARY:
+            return JBT_BYTES;
+        case NT_DATE:
+            return JBT_TIMESTAMP;
+        case NT_NUMBER:
+            return JBT_NUMBER;
+        default:
+            break;
+    }
+    return JBT_NONE;
+}
+
+// returns the bind type for all values of the given argument or JBT_NONE if the values have different types
+static JdbcBindType get_column_bind_type(QoreValue arg) {
+    if (arg.getType() != NT_LIST) {
+        return get_bind_type(arg.getType());
+    }
 
-            case NT_INT:
-                return "int";
+    JdbcBindType rv = JBT_NULL;
+    ConstListIterator i(arg.get<const QoreListNode>());
+    while (i.next()) {
+        JdbcBindType t = get_bind_type(i.getValue().getType());
+        if (t == JBT_NULL) {
+            continue;
+        }
+        if (t == JBT_NONE || (rv != JBT_NULL && rv != t)) {
+            return JBT_NONE;
+        }
+        rv = t;
+    }
+    return rv;
+}
 
-            case NT_FLOAT:
-                return "double";
+// creates the Java value array and null mask for a column-wise bind; non-list arguments are passed as
+// single-element arrays and used for all rows
+static void make_bind_column(Env& env, JdbcBindType type, QoreValue arg, size_t list_size,
+        LocalReference<jobject>& rv, LocalReference<jobject>& rv_nulls) {
+    const QoreListNode* l = arg.getType() == NT_LIST ? arg.get<const QoreListNode>() : nullptr;
+    jsize n = l ? list_size : 1;
+    auto get_value = [l, arg] (jsize i) -> QoreValue {
+        return l ? l->retrieveEntry(i) : arg;
+    };
+
+    switch (type) {
+        case JBT_LONG:
+        case JBT_TIMESTAMP: {
+            std::vector<jlong> vals(n);
+            std::vector<jboolean> nulls(n);
+            for (jsize i = 0; i < n; ++i) {
+                QoreValue v = get_value(i);
+                nulls[i] = v.isNullOrNothing();
+                if (nulls[i]) {
+                    vals[i] = 0;
+                } else if (type == JBT_LONG) {
+                    vals[i] = v.getAsBigInt();
+                } else {
+                    const DateTimeNode* dt = v.get<const DateTimeNode>();
+                    vals[i] = dt->getEpochSecondsUTC() * 1000000 + dt->getMicrosecond();
+                }
+            }
+            LocalReference<jlongArray> a = env.newLongArray(n);
+            env.setLongArrayRegion(a, 0, n, &vals[0]);
+            LocalReference<jbooleanArray> na = env.newBooleanArray(n);
+            env.setBooleanArrayRegion(na, 0, n, &nulls[0]);
+            rv = a.release();
+            rv_nulls = na.release();
+            break;
+        }
 
-            case NT_NUMBER:
-                return "numeric";
+        case JBT_DOUBLE: {
+            std::vector<jdouble> vals(n);
+            std::vector<jboolean> nulls(n);
+            for (jsize i = 0; i < n; ++i) {
+                QoreValue v = get_value(i);
+                nulls[i] = v.isNullOrNothing();
+                vals[i] = nulls[i] ? 0 : v.getAsFloat();
+            }
+            LocalReference<jdoubleArray> a = env.newDoubleArray(n);
+            env.setDoubleArrayRegion(a, 0, n, &vals[0]);
+            LocalReference<jbooleanArray> na = env.newBooleanArray(n);
+            env.setBooleanArrayRegion(na, 0, n, &nulls[0]);
+            rv = a.release();
+            rv_nulls = na.release();
+            break;
+        }
 
-            case NT_STRING:
-                return "varchar";
+        case JBT_BOOLEAN: {
+            std::vector<jboolean> vals(n);
+            std::vector<jboolean> nulls(n);
+            for (jsize i = 0; i < n; ++i) {
+                QoreValue v = get_value(i);
+                nulls[i] = v.isNullOrNothing();
+                vals[i] = nulls[i] ? false : v.getAsBool();
+            }
+            LocalReference<jbooleanArray> a = env.newBooleanArray(n);
+            env.setBooleanArrayRegion(a, 0, n, &vals[0]);
+            LocalReference<jbooleanArray> na = env.newBooleanArray(n);
+            env.setBooleanArrayRegion(na, 0, n, &nulls[0]);
+            rv = a.release();
+            rv_nulls = na.release();
+            break;
+        }
 
-            case NT_BOOLEAN:
-                return "boolean";
+        case JBT_STRING:
+        case JBT_NUMBER: {
+            LocalReference<jobjectArray> a = env.newObjectArray(n, Globals::classString);
+            for (jsize i = 0; i < n; ++i) {
+                QoreValue v = get_value(i);
+                if (v.isNullOrNothing()) {
+                    continue;
+                }
+                LocalReference<jstring> str;
+                if (type == JBT_STRING) {
+                    str = env.newString(v.get<const QoreStringNode>()->c_str());
+                } else {
+                    QoreString num;
+                    v.get<const QoreNumberNode>()->toString(num);
+                    str = env.newString(num.c_str());
+                }
+                env.setObjectArrayElement(a, i, str);
+            }
+            rv = a.release();
+            break;
+        }
 
-            case NT_DATE:
-                return "timestamp";
+        case JBT_BYTES: {
+            LocalReference<jobjectArray> a = env.newObjectArray(n, Globals::classObject);
+            for (jsize i = 0; i < n; ++i) {
+                QoreValue v = get_value(i);
+                if (v.isNullOrNothing()) {
+                    continue;
+                }
+                LocalReference<jbyteArray> b = QoreToJava::makeByteArray(env, *v.get<const BinaryNode>());
+                env.setObjectArrayElement(a, i, b);
+            }
+            rv = a.release();
+            break;
+        }
 
-            case NT_BINARY:
-                return "blob";
+        default:
+            assert(type == JBT_NULL);
+            break;
+    }
+}
 
-            default:
-                return i.getValue().getTypeName();
+int QoreJdbcStatement::bindInternArrayColumns(Env& env, const QoreListNode* args, size_t list_size,
+        ExceptionSink* xsink) {
+    size_t arg_count = args->size();
+
+    std::vector<jint> types(arg_count);
+    for (size_t j = 0; j < arg_count; ++j) {
+        QoreValue arg = args->retrieveEntry(j);
+        if (arg.getType() == NT_LIST && arg.get<const QoreListNode>()->size() != list_size) {
+            xsink->raiseException("JDBC-BIND-ERROR", "the array size for bind argument %d (starting from 1) "
+                "is %zu which is inconsistent with the detected array size %zu.  This is an error, because "
+                "all array bind arguments must have the same array / list size.", (int)j,
+                arg.get<const QoreListNode>()->size(), list_size);
+            return -1;
+        }
+        JdbcBindType t = get_column_bind_type(arg);
+        if (t == JBT_NONE) {
+            return 1;
         }
+        types[j] = t;
+    }
+
+    LocalReference<jintArray> jtypes = env.newIntArray(arg_count);
+    env.setIntArrayRegion(jtypes, 0, arg_count, &types[0]);
+    LocalReference<jobjectArray> jvalues = env.newObjectArray(arg_count, Globals::classObject);
+    LocalReference<jobjectArray> jnulls = env.newObjectArray(arg_count, Globals::classObject);
+
+    for (size_t j = 0; j < arg_count; ++j) {
+        LocalReference<jobject> vals;
+        LocalReference<jobject> nulls;
+        make_bind_column(env, (JdbcBindType)types[j], args->retrieveEntry(j), list_size, vals, nulls);
+        env.setObjectArrayElement(jvalues, j, vals);
+        env.setObjectArrayElement(jnulls, j, nulls);
     }
 
-    return "null";
+    // the rows are bound to the statement when it is executed
+    std::vector<jvalue> jargs(3);
+    jargs[0].l = jtypes;
+    jargs[1].l = jvalues;
+    jargs[2].l = jnulls;
+    batch_binder = env.newObject(Globals::classJdbcBatchBinder, Globals::ctorJdbcBatchBinder, &jargs[0]);
+    return 0;
+}
+
+// returns the SQL element type name used with Connection.createArrayOf() for the given bind type
+static const char* get_array_type_name(JdbcBindType type) {
+    switch (type) {
+        case JBT_LONG:
+            return "bigint";
+        case JBT_DOUBLE:
+            return "float";
+        case JBT_BOOLEAN:
+            return "boolean";
+        case JBT_TIMESTAMP:
+            return "timestamp";
+        case JBT_NUMBER:
+            return "numeric";
+        case JBT_BYTES:
+            return "varbinary";
+        default:
+            break;
+    }
+    return "varchar";
+}
+
+static LocalReference<jobjectArray> make_array_elements(Env& env, JdbcBindType type, QoreValue arg) {
+    size_t size = arg.get<const QoreListNode>()->size();
+    if (type == JBT_NULL || !size) {
+        return env.newObjectArray(size, Globals::classString);
+    }
+    LocalReference<jobject> vals;
+    LocalReference<jobject> nulls;
+    make_bind_column(env, type, arg, size, vals, nulls);
+
+    std::vector<jvalue> jargs(3);
+    jargs[0].i = type;
+    jargs[1].l = vals;
+    jargs[2].l = nulls;
+    return env.callStaticObjectMethod(Globals::classJdbcBatchBinder, Globals::methodJdbcBatchBinderToArray,
+        &jargs[0]).as<jobjectArray>();
 }
 
 int QoreJdbcStatement::bindInternArrayNative(Env& env, const QoreListNode* args, ExceptionSink* xsink) {
-    size_t count = args ? args->size() : 0;
-    for (unsigned int i = 0; i < count; ++i) {
+    size_t count = args->size();
+
+    // check all list arguments before binding; binary lists and lists with mixed types use batch binding
+    std::vector<JdbcBindType> types(count, JBT_NONE);
+    for (size_t i = 0; i < count; ++i) {
         QoreValue arg = args->retrieveEntry(i);
+        if (arg.getType() != NT_LIST) {
+            continue;
+        }
+        types[i] = get_column_bind_type(arg);
+        if (types[i] == JBT_NONE || types[i] == JBT_BYTES) {
+            return 1;
+        }
+    }
 
+    for (size_t i = 0; i < count; ++i) {
+        QoreValue arg = args->retrieveEntry(i);
         if (arg.getType() != NT_LIST) {
             if (bindParamSingleValue(env, i + 1, arg, xsink)) {
                 return -1;
@@ -762,43 +1567,103 @@ int QoreJdbcStatement::bindInternArrayNative(Env& env, const QoreListNode* args,
             continue;
         }
 
-        const char* bind_type = getArrayBindType(arg.get<const QoreListNode>());
-        printd(0, "QoreJdbcStatement::bindInternArray() binding array of SQL type '%s'\n", bind_type);
+        const char* type_name = get_array_type_name(types[i]);
+        printd(5, "QoreJdbcStatement::bindInternArrayNative() binding array of SQL type '%s'\n", type_name);
+
+        LocalReference<jobjectArray> elements = make_array_elements(env, types[i], arg);
+        LocalReference<jobject> array = conn->createArray(env, type_name, elements);
 
         std::vector<jvalue> jargs(2);
-        LocalReference<jstring> jurl = env.newString(bind_type);
-        jargs[0].l = jurl;
-        LocalReference<jobject> array_arg = QoreToJava::toAnyObject(env, arg, conn->getQoreJniContext());
-        jargs[1].l = array_arg;
-        LocalReference<jobject> array = env.callObjectMethod(conn->getConnectionObject(),
-            Globals::methodConnectionCreateArrayOf, &jargs[0]);
-        jargs[0].l = array;
+        jargs[0].i = i + 1;
+        jargs[1].l = array;
         env.callVoidMethod(stmt, Globals::methodPreparedStatementSetArray, &jargs[0]);
     }
+    // bind excess positions with NULL
+    for (unsigned i = count; i < bind_size; ++i) {
+        if (bindParamSingleValue(env, i + 1, QoreValue(), xsink)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int QoreJdbcStatement::bindTypedArray(Env& env, int column, const QoreHashNode* h, ExceptionSink* xsink) {
+    QoreValue type = h->getKeyValue("^jdbctype^");
+    QoreValue value = h->getKeyValue("^value^");
+    if (type.getType() != NT_STRING || (value.getType() != NT_LIST && !value.isNullOrNothing())) {
+        xsink->raiseException("JDBC-BIND-ERROR", "cannot bind hash argument %d (starting from 1); only hashes with "
+            "a string '^jdbctype^' key and a list '^value^' key can be bound as SQL arrays", column);
+        return -1;
+    }
+
+    std::vector<jvalue> jargs(2);
+    jargs[0].i = column;
+    if (value.isNullOrNothing()) {
+        jargs[1].i = Globals::typeArray;
+        env.callVoidMethod(stmt, Globals::methodPreparedStatementSetNull, &jargs[0]);
+        return 0;
+    }
+
+    JdbcBindType t = get_column_bind_type(value);
+    if (t == JBT_NONE) {
+        xsink->raiseException("JDBC-BIND-ERROR", "cannot bind SQL array argument %d (starting from 1) of type '%s'; "
+            "all list elements must have the same supported type", column, type.get<const QoreStringNode>()->c_str());
+        return -1;
+    }
 
+    LocalReference<jobjectArray> elements = make_array_elements(env, t, value);
+    LocalReference<jobject> array = conn->createArray(env, type.get<const QoreStringNode>()->c_str(), elements);
+    jargs[1].l = array;
+    env.callVoidMethod(stmt, Globals::methodPreparedStatementSetArray, &jargs[0]);
     return 0;
 }
-#endif
 
 int QoreJdbcStatement::bindInternArrayBatch(Env& env, const QoreListNode* args, ExceptionSink* xsink) {
     do_batch_execute = true;
-    size_t list_size = findArraySizeOfArgs(args);
+    batch_rows = findArraySizeOfArgs(args);
     size_t arg_count = args ? args->size() : 0;
 
-    for (size_t i = 0; i < list_size; ++i) {
+    // stage all rows column by column if possible; rows are bound and executed by execIntern()
+    if (arg_count) {
+        int rc = bindInternArrayColumns(env, args, batch_rows, xsink);
+        if (rc <= 0) {
+            return rc;
+        }
+    }
+
+    // otherwise the rows are bound row by row from the arguments when the statement is executed
+    for (unsigned int j = 0; j < arg_count; ++j) {
+        QoreValue arg = args->retrieveEntry(j);
+        if (arg.getType() == NT_LIST && arg.get<const QoreListNode>()->size() != batch_rows) {
+            xsink->raiseException("JDBC-BIND-ERROR", "the array size for bind argument %d (starting from 1) "
+                "is %zu which is inconsistent with the detected array size %zu.  This is an error, because "
+                "all array bind arguments must have the same array / list size.", (int)j,
+                arg.get<const QoreListNode>()->size(), batch_rows);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int QoreJdbcStatement::bindBatchRows(Env& env, size_t start, size_t end, ExceptionSink* xsink) {
+    if (batch_binder) {
+        std::vector<jvalue> jargs(3);
+        jargs[0].l = stmt;
+        jargs[1].i = (jint)start;
+        jargs[2].i = (jint)end;
+        env.callVoidMethod(batch_binder, Globals::methodJdbcBatchBinderBind, &jargs[0]);
+        return 0;
+    }
+
+    const QoreListNode* args = *params;
+    size_t arg_count = args ? args->size() : 0;
+    for (size_t i = start; i < end; ++i) {
         for (unsigned int j = 0; j < arg_count; ++j) {
             QoreValue arg = args->retrieveEntry(j);
             // get value to bind from the list if necessary
             if (arg.getType() == NT_LIST) {
-                const QoreListNode* l = arg.get<const QoreListNode>();
-                if (l->size() != list_size) {
-                    xsink->raiseException("JDBC-BIND-ERROR", "the array size for bind argument %d (starting from 1) "
-                        "is %zu which is inconsistent with the detected array size %zu.  This is an error, because "
-                        "all array bind arguments must have the same array / list size.", (int)j, l->size(),
-                        list_size);
-                    return -1;
-                }
-                arg = l->retrieveEntry(i);
+                arg = arg.get<const QoreListNode>()->retrieveEntry(i);
             }
             if (bindParamSingleValue(env, j + 1, arg, xsink)) {
                 return -1;
@@ -809,4 +1674,20 @@ int QoreJdbcStatement::bindInternArrayBatch(Env& env, const QoreListNode* args,
     return 0;
 }
 
+int QoreJdbcStatement::executeBatchRows(Env& env, ExceptionSink* xsink) {
+    // execute large batches in sub-batches of at most "batch-size" rows
+    size_t batch_size = conn->getBatchSize() > 0 ? (size_t)conn->getBatchSize() : batch_rows;
+    size_t start = 0;
+    do {
+        size_t end = std::min(start + batch_size, batch_rows);
+        if (bindBatchRows(env, start, end, xsink)) {
+            return -1;
+        }
+        // ignore return value
+        env.callObjectMethod(stmt, Globals::methodPreparedStatementExecuteBatch, nullptr);
+        start = end;
+    } while (start < batch_rows);
+    return 0;
+}
+
 }
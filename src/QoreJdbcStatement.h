@@ -28,6 +28,7 @@
 #include <qore/Qore.h>
 
 #include "QoreJdbcConnection.h"
+#include "QoreJdbcColumn.h"
 #include "Env.h"
 #include "GlobalReference.h"
 #include "LocalReference.h"
@@ -37,22 +38,22 @@
 
 namespace jni {
 
-struct QoreJdbcColumn {
-    //! Column name in the DB
-    std::string name;
-
-    //! Column name in the output query
-    std::string qname;
-
-    //! Strip trailing spaces from string values retrieved (CHAR columns)
-    bool strip = false;
-
-    //! Constructor
-    DLLLOCAL QoreJdbcColumn(std::string&& name, std::string&& qname, jint ctype);
+//! Column-wise array bind types; must match the constants in org.qore.jni.JdbcBatchBinder
+enum JdbcBindType {
+    //! the values cannot be bound column-wise
+    JBT_NONE = -1,
+    //! all values are NULL
+    JBT_NULL = 0,
+    JBT_LONG,
+    JBT_DOUBLE,
+    JBT_BOOLEAN,
+    JBT_STRING,
+    JBT_BYTES,
+    JBT_TIMESTAMP,
+    JBT_NUMBER,
 };
 
-// column vector
-typedef std::vector<QoreJdbcColumn> cvec_t;
+class QoreListArray;
 
 class QoreJdbcStatement {
 public:
@@ -107,6 +108,50 @@ public:
     */
     DLLLOCAL void close(Env& env);
 
+    //! Starts reading the result set in blocks in a background thread with a Java JdbcRowPrefetcher
+    /** the result set must not be used directly while prefetching is active
+
+        @param env the JNI environment
+        @param block_size the maximum number of rows in a block
+        @param queue_size the maximum number of blocks read in advance
+    */
+    DLLLOCAL void startPrefetch(Env& env, int block_size, int queue_size);
+
+    //! Returns true if the result set is being read in a background thread
+    DLLLOCAL bool isPrefetching() const {
+        return (bool)prefetcher;
+    }
+
+    //! Stops the background readers of other statements on the connection before it's used by this statement
+    DLLLOCAL void stopOtherPrefetchers(Env& env) {
+        conn->stopPrefetchers(*env, prefetcher);
+    }
+
+    //! Advances to the next prefetched row
+    /** @return true if a row is available, false if there are no more rows or an error occurred
+    */
+    DLLLOCAL bool prefetchNext(Env& env, ExceptionSink* xsink);
+
+    //! Returns the current prefetched row as a hash
+    DLLLOCAL QoreHashNode* getPrefetchRow(ExceptionSink* xsink);
+
+    //! Returns the next prefetched rows as a list of hashes
+    /** @param env the JNI environment
+        @param xsink exception sink
+        @param max_rows maximum count of rows to return; if <= 0 the count of returned rows is not limited
+    */
+    DLLLOCAL QoreListNode* getPrefetchOutputList(Env& env, ExceptionSink* xsink, int max_rows);
+
+    //! Returns the next prefetched rows as a hash of column lists
+    /** @param env the JNI environment
+        @param xsink exception sink
+        @param empty_hash_if_nothing whether to return empty hash or empty hash with column names when no rows
+        available
+        @param max_rows maximum count of rows to return; if <= 0 the count of returned rows is not limited
+    */
+    DLLLOCAL QoreHashNode* getPrefetchOutputHash(Env& env, ExceptionSink* xsink, bool empty_hash_if_nothing,
+            int max_rows);
+
 protected:
     //! Possible comment types; used in the parse() method
     enum SQLCommentType {
@@ -121,6 +166,12 @@ protected:
     //! PreparedStatement object
     GlobalReference<jobject> stmt;
 
+    //! The SQL used to prepare the statement; used as the statement cache key
+    std::string stmt_sql;
+
+    //! The connection generation when the statement was acquired
+    unsigned stmt_gen = 0;
+
     //! Count of bind parameters for the SQL command
     size_t bind_size = 0;
 
@@ -136,9 +187,43 @@ protected:
     //! Any active result set
     LocalReference<jobject> rs;
 
+    //! Block fetcher for the active result set, if rows have been retrieved in blocks
+    LocalReference<jobject> block_fetcher;
+
+    //! Block size of the block fetcher
+    int block_fetcher_size = 0;
+
     //! Batch execute flag
     bool do_batch_execute = false;
 
+    //! Java JdbcBatchBinder with the rows staged for batch execution
+    /** if not set for a batch execution, the rows are bound from the bind arguments when executed
+    */
+    LocalReference<jobject> batch_binder;
+
+    //! Number of rows for batch execution
+    size_t batch_rows = 0;
+
+    //! Background result set reader, if prefetching is active
+    GlobalReference<jobject> prefetcher;
+
+    //! Column lists for the current prefetched block
+    std::vector<QoreListNode*> prefetch_block;
+
+    //! Number of rows in the current prefetched block
+    size_t prefetch_rows = 0;
+
+    //! Number of rows of the current prefetched block returned so far; the current row is prefetch_pos - 1
+    size_t prefetch_pos = 0;
+
+    //! org.qore.jni.JdbcBindStream objects bound to the statement; detached after execution
+    std::vector<GlobalReference<jobject>> bind_streams;
+
+    //! True if a %Qore or Java InputStream object is bound
+    /** such statements are not executed again after reconnecting, as the streams cannot be read again
+    */
+    bool input_stream_bound = false;
+
     DLLLOCAL void prepareAndBindStatement(Env& env, ExceptionSink* xsink, const QoreString& str);
 
     DLLLOCAL void prepareStatement(Env& env, const QoreString& str);
@@ -167,10 +252,26 @@ protected:
 
     DLLLOCAL bool execIntern(Env& env, const QoreString& sql, ExceptionSink* xsink);
 
-#if 0
-    DLLLOCAL const char* getArrayBindType(const QoreListNode* l) const;
-    int bindInternArrayNative(Env& env, const QoreListNode* args, ExceptionSink* xsink);
-#endif
+    //! Binds list arguments as SQL arrays for a single execution
+    /** @return 0 for OK, -1 for error, 1 if the arguments cannot be bound as SQL arrays
+    */
+    DLLLOCAL int bindInternArrayNative(Env& env, const QoreListNode* args, ExceptionSink* xsink);
+
+    //! Binds a hash with \c "^jdbctype^" and \c "^value^" keys as a SQL array
+    DLLLOCAL int bindTypedArray(Env& env, int column, const QoreHashNode* h, ExceptionSink* xsink);
+
+    //! Binds a binary value as a stream that reads the value's memory directly
+    /** the value must remain valid until the statement has been executed
+    */
+    DLLLOCAL void bindBinaryStream(Env& env, int column, const BinaryNode& b);
+
+    //! Binds a %Qore \c InputStream or Java \c java.io.InputStream object as a stream
+    DLLLOCAL int bindInputStream(Env& env, int column, const QoreObject* obj, ExceptionSink* xsink);
+
+    //! Detaches all bound streams from their values so that they cannot be read after execution
+    /** does not throw C++ exceptions
+    */
+    DLLLOCAL void detachBindStreams(JNIEnv* env);
 
     //! Return size of arrays in the passed arguments
     /** @param args SQL parameters
@@ -223,16 +324,80 @@ protected:
     */
     DLLLOCAL int bindInternArray(Env& env, const QoreListNode* args, ExceptionSink* xsink);
 
-    int bindInternArrayBatch(Env& env, const QoreListNode* args, ExceptionSink* xsink);
+    //! Prepares a list of arrays of SQL parameters for batch execution
+    /** the rows are staged column by column if possible; they are bound and executed by executeBatchRows()
+    */
+    DLLLOCAL int bindInternArrayBatch(Env& env, const QoreListNode* args, ExceptionSink* xsink);
+
+    //! Binds the given rows of a batch execution and adds them to the statement's batch
+    /** @param env the JNI environment variable
+        @param start the first row to bind
+        @param end the row after the last row to bind
+        @param xsink exception sink
+
+        @return 0 for OK, -1 for error
+    */
+    DLLLOCAL int bindBatchRows(Env& env, size_t start, size_t end, ExceptionSink* xsink);
+
+    //! Binds and executes all rows of a batch execution in sub-batches of at most \c "batch-size" rows
+    /** @return 0 for OK, -1 for error
+    */
+    DLLLOCAL int executeBatchRows(Env& env, ExceptionSink* xsink);
+
+    //! Stage a list of arrays of SQL parameters column by column in a Java JdbcBatchBinder
+    /** @param env the JNI environment variable
+        @param args SQL parameters
+        @param list_size the array bind size
+        @param xsink exception sink
+
+        @return 0 for OK, -1 for error, 1 if the arguments cannot be staged column-wise
+    */
+    DLLLOCAL int bindInternArrayColumns(Env& env, const QoreListNode* args, size_t list_size, ExceptionSink* xsink);
 
     //! Describe result set
+    /** column descriptions from a previous execution of the same prepared statement are reused if the column count
+        and types have not changed
+    */
     DLLLOCAL int describeResultSet(Env& env, ExceptionSink* xsink);
 
+    //! Returns true if the current column descriptions match the column count and types of the result set
+    DLLLOCAL bool checkCachedColumns(Env& env);
+
     DLLLOCAL void populateOutputHash(QoreHashNode& h, ExceptionSink* xsink);
 
     DLLLOCAL QoreHashNode* getOutputHashIntern(Env& env, ExceptionSink* xsink, bool empty_hash_if_nothing,
             int max_rows = -1);
 
+    //! Retrieves the remaining rows of the result set in blocks with a Java JdbcBlockFetcher
+    /** @param env the JNI environment
+        @param l the output column lists
+        @param row_count the number of rows retrieved
+        @param block_size the maximum number of rows retrieved in a single call
+        @param max_rows the maximum number of rows to retrieve; <= 0 = all remaining rows
+        @param xsink for Qore-language exceptions
+
+        @return 0 = OK, -1 = error (exception raised)
+    */
+    DLLLOCAL int getOutputHashBlockIntern(Env& env, QoreListArray& l, size_t& row_count, int block_size,
+            int max_rows, ExceptionSink* xsink);
+
+    //! Returns a Java int array with the fetch strategy for each column
+    DLLLOCAL LocalReference<jintArray> getFetchTypes(Env& env) const;
+
+    //! Appends the rows of a Java JdbcBlockFetcher block to the given column lists
+    /** @param env the JNI environment
+        @param fetcher the JdbcBlockFetcher holding the block
+        @param rows the number of rows in the block
+        @param l the output column lists, which must already be populated
+        @param xsink for Qore-language exceptions
+
+        @return 0 = OK, -1 = error (exception raised)
+    */
+    DLLLOCAL int convertBlock(Env& env, jobject fetcher, jint rows, QoreListArray& l, ExceptionSink* xsink);
+
+    //! Dereferences the column lists of the current prefetched block
+    DLLLOCAL void clearPrefetchBlock(ExceptionSink* xsink);
+
     DLLLOCAL QoreListNode* getOutputListIntern(Env& env, ExceptionSink* xsink, int max_rows = -1);
 
     //! Get a column's value and return a Qore value for it
@@ -246,6 +411,17 @@ protected:
     */
     DLLLOCAL QoreValue getColumnValue(Env& env, int column, QoreJdbcColumn& col, ExceptionSink* xsink);
 
+    //! Converts a non-null column value retrieved with the column's fetch strategy to a Qore value
+    /** @param env the JNI environment
+        @param val the non-null Java value
+        @param col the column description
+        @param xsink for Qore-language exceptions
+
+        @return result value
+    */
+    DLLLOCAL QoreValue convertColumnObject(Env& env, LocalReference<jobject>& val, QoreJdbcColumn& col,
+            ExceptionSink* xsink);
+
     //! Get one result row as a hash
     /** @param enc the JNI environment variable
         @param xsink exception sink
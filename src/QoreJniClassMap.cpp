@@ -71,11 +71,14 @@ JniQoreClass* QC_ZONEDDATETIME;
 // the Qore class ID for java::time::ZonedDateTime
 qore_classid_t CID_ZONEDDATETIME;
 
-bool QoreJniClassMap::init_done = false;
-#ifdef JNI_INIT_BACKGROUND
+std::atomic<bool> QoreJniClassMap::init_done = {false};
 std::mutex QoreJniClassMap::init_mutex;
 std::condition_variable QoreJniClassMap::init_cond;
-#endif
+std::atomic<bool> QoreJniClassMap::init_pending = {false};
+bool QoreJniClassMap::init_failed = false;
+bool QoreJniClassMap::init_background = false;
+std::string QoreJniClassMap::init_err;
+std::string QoreJniClassMap::init_desc;
 
 QoreJniClassMap qjcm;
 static void exec_java_constructor(const QoreMethod& meth, BaseMethod* m, QoreObject* self, const QoreListNode* args,
@@ -206,6 +209,11 @@ JniExternalProgramData* jni_get_context_unconditional() {
 JniExternalProgramData* jni_get_context_unconditional(QoreProgram*& pgm) {
     JniExternalProgramData* jpc = jni_get_context(pgm);
     if (!jpc) {
+        // the Jni namespace is added to the current Program on first use with background initialization
+        pgm = QoreJniClassMap::isBackgroundInit() ? getProgram() : nullptr;
+        if (pgm && pgm->checkFeature(QORE_JNI_MODULE_NAME)) {
+            return JniExternalProgramData::getCreateJniProgramData(pgm);
+        }
         pgm = Globals::getJavaContextProgram();
         jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
         assert(jpc);
@@ -236,50 +244,84 @@ static QoreNamespace* jni_find_create_namespace(QoreNamespace& jns, const char*
     return ns;
 }
 
-#ifdef JNI_INIT_BACKGROUND
 void QoreJniClassMap::staticInitBackground(ExceptionSink* xsink, void* pgm_ptr) {
     QoreProgram* pgm = static_cast<QoreProgram*>(pgm_ptr);
     // set program context for initialization
     QoreProgramContextHelper pgm_ctx(pgm);
 
-    // ensure that the parent thread is signaled on exit
+    // ensure that waiting threads are signaled on exit
     InitSignaler signaler;
+    ExceptionSink init_xsink;
     try {
         qjcm.initIntern(pgm);
     } catch (jni::Exception& e) {
-        e.convert(xsink);
+        e.convert(&init_xsink);
+    }
+
+    if (init_xsink) {
+        // save the error so that it can be raised in every thread that needs the class map
+        QoreValue err = init_xsink.getExceptionErr();
+        QoreValue desc = init_xsink.getExceptionDesc();
+        init_err = err.getType() == NT_STRING ? err.get<const QoreStringNode>()->c_str() : "JNI-INIT-ERROR";
+        init_desc = desc.getType() == NT_STRING
+            ? desc.get<const QoreStringNode>()->c_str()
+            : "unknown error initializing the jni module";
+        init_failed = true;
+        printd(LogLevel, "QoreJniClassMap::staticInitBackground() initialization failed: %s: %s\n",
+            init_err.c_str(), init_desc.c_str());
+        init_xsink.clear();
+    } else {
+        jni_qore_init_done.store(true, std::memory_order_release);
+    }
+}
+
+void QoreJniClassMap::waitForInitIntern() {
+    {
+        std::unique_lock<std::mutex> init_lock(init_mutex);
+        while (init_pending.load(std::memory_order_acquire)) {
+            init_cond.wait(init_lock);
+        }
+    }
+
+    if (init_failed) {
+        throw QoreJniException(init_err, "%s", init_desc.c_str());
     }
 }
-#endif
 
-void QoreJniClassMap::init(QoreProgram* pgm, bool already_initialized) {
+bool QoreJniClassMap::init(QoreProgram* pgm, bool already_initialized, bool background) {
     assert(pgm);
     if (already_initialized) {
         qjcm.initIntern(pgm);
-        return;
+        return false;
     }
 
-    // issue #3199: perform initialization in the background
     ExceptionSink xsink;
-#ifdef JNI_INIT_BACKGROUND
-    // grab init mutex
-    std::unique_lock<std::mutex> init_lock(init_mutex);
-    q_start_thread(&xsink, &staticInitBackground, pgm);
-    // wait for initialization to complete
-    init_cond.wait(init_lock);
-#else
-    // there should be no reason to initialize in a background thread
+    if (background) {
+        // issue #3199: perform initialization in the background; the first access to the class map waits for
+        // initialization to complete
+        init_pending.store(true, std::memory_order_release);
+        q_start_thread(&xsink, &staticInitBackground, pgm);
+        if (xsink) {
+            // the thread could not be started; initialize in this thread instead
+            init_pending.store(false, std::memory_order_release);
+            xsink.clear();
+        } else {
+            init_background = true;
+            printd(LogLevel, "QoreJniClassMap::init() initializing in the background\n");
+            return true;
+        }
+    }
+
     try {
         qjcm.initIntern(pgm);
     } catch (jni::Exception& e) {
         e.convert(&xsink);
     }
-#endif
 
-    // if the background thread threw an exception, then rethrow it here
     if (xsink) {
         throw XsinkException(xsink);
     }
+    return false;
 }
 
 void QoreJniClassMap::initIntern(QoreProgram* pgm) {
@@ -319,16 +361,13 @@ void QoreJniClassMap::initIntern(QoreProgram* pgm) {
     CID_ZONEDDATETIME = QC_ZONEDDATETIME->getID();
 
     // populate classes after initial hierarchy done
-    init_done = true;
+    init_done.store(true, std::memory_order_release);
 
     // now populate all classes created up until now
     {
         // copy all classes to a vector
         std::vector<JniQoreClass*> cvec;
-        cvec.reserve(jcmap.size());
-        for (auto& i : jcmap) {
-            cvec.push_back(i.second);
-        }
+        getClassList(cvec);
         // populate all classes in the vector
         for (auto& i : cvec) {
             populateQoreClass(*i, static_cast<Class*>(i->getManagedUserData()), pgm);
@@ -336,8 +375,12 @@ void QoreJniClassMap::initIntern(QoreProgram* pgm) {
     }
 
     // rescan all classes
-    for (auto& i : jcmap) {
-        i.second->rescanParents();
+    {
+        std::vector<JniQoreClass*> cvec;
+        getClassList(cvec);
+        for (auto& i : cvec) {
+            i->rescanParents();
+        }
     }
 
     // add low-level API classes
@@ -348,6 +391,7 @@ void QoreJniClassMap::initIntern(QoreProgram* pgm) {
 
         jni->addSystemClass(initQoreInvocationHandlerClass(*jni));
         jni->addSystemClass(initJavaArrayClass(*jni));
+        jni->addSystemClass(initJavaFutureClass(*jni));
 
         // add low-level API functions
         init_jni_functions(*jni);
@@ -381,6 +425,7 @@ void QoreJniClassMap::destroy(ExceptionSink& xsink) {
     default_jns->clear(&xsink);
     delete default_jns;
     default_jns = nullptr;
+    deletePendingClasses();
 }
 
 // takes an internal name (ex: java/lang/Class)
@@ -391,40 +436,39 @@ jclass QoreJniClassMap::findLoadClass(const QoreString& name, QoreProgram* pgm)
 
 // takes an internal name (ex: java/lang/Class)
 jclass QoreJniClassMap::findLoadClass(const char* jpath, QoreProgram* pgm) {
-    JniQoreClass* qc;
-    {
-        AutoLocker al(m);
-        jcmap_t::iterator i = jcmap.find(jpath);
-        if (i != jcmap.end()) {
-            qc = i->second;
-            //printd(LogLevel, "findLoadClass() '%s': %p (cached)\n", jpath, qc);
-        } else {
-            JniExternalProgramData* jpc;
-            if (!pgm) {
-                jpc = jni_get_context();
-            } else {
-                jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
-            }
-            if (jpc) {
-                assert(static_cast<QoreJniClassMapBase*>(jpc) != static_cast<QoreJniClassMapBase*>(this));
-                qc = jpc->find(jpath);
-            }
+    // lookups of already-created classes do not block
+    JniQoreClass* qc = findInternal(jpath);
+    if (qc) {
+        //printd(LogLevel, "findLoadClass() '%s': %p (cached)\n", jpath, qc);
+        return static_cast<Class*>(qc->getManagedUserData())->toLocal();
+    }
 
-            //printd(5, "findLoadClass() '%s': qc: %p pgm: %p jpc: %p\n", jpath, qc, pgm, jpc);
-            if (!qc) {
-                Env env;
-                bool base;
-                SimpleRefHolder<Class> cls(loadClass(env, jpath, base, jpc));
-
-                QoreString cpath(jpath);
-                cpath.replaceAll("/", ".");
-                //cpath.replaceAll("$", "__");
-                qc = findCreateQoreClass(env, cpath, jpath, cls.release(), base, pgm);
-                //printd(5, "findLoadClass() '%s': %p (created) pgm: %p\n", jpath, qc, pgm);
-            } else {
-                //printd(LogLevel, "findLoadClass() '%s': %p (cached 2)\n", jpath, qc);
-            }
-        }
+    JniExternalProgramData* jpc;
+    if (!pgm) {
+        jpc = jni_get_context();
+    } else {
+        jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
+    }
+    if (jpc) {
+        assert(static_cast<QoreJniClassMapBase*>(jpc) != static_cast<QoreJniClassMapBase*>(this));
+        qc = jpc->find(jpath);
+    }
+
+    //printd(5, "findLoadClass() '%s': qc: %p pgm: %p jpc: %p\n", jpath, qc, pgm, jpc);
+    if (!qc) {
+        // load the Java class before acquiring the class map lock
+        Env env;
+        bool base;
+        SimpleRefHolder<Class> cls(loadClass(env, jpath, base, jpc));
+
+        QoreString cpath(jpath);
+        cpath.replaceAll("/", ".");
+        //cpath.replaceAll("$", "__");
+        AutoLocker al(m);
+        qc = findCreateQoreClass(env, cpath, jpath, cls.release(), base, pgm);
+        //printd(5, "findLoadClass() '%s': %p (created) pgm: %p\n", jpath, qc, pgm);
+    } else {
+        //printd(LogLevel, "findLoadClass() '%s': %p (cached 2)\n", jpath, qc);
     }
 
     return static_cast<Class*>(qc->getManagedUserData())->toLocal();
@@ -546,12 +590,28 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClass(Env& env, LocalReference<jcla
     LocalReference<jobject> cl = env.callObjectMethod(jc, Globals::methodClassGetClassLoader, nullptr);
     bool base = (!baseClassLoader && !cl) || (cl && baseClassLoader && env.isSameObject(baseClassLoader, cl));
     printd(5, "QoreJniClassMap::findCreateQoreClass() '%s' base: %d\n", jpath.c_str(), base);
-    return findCreateQoreClass(env, cname, jpath.c_str(), new Class(jc), base, pgm);
+    JniQoreClass* qc = findCreateQoreClass(env, cname, jpath.c_str(), new Class(jc), base, pgm);
+    // the class is being used to wrap a Java object; make sure that it's populated
+    if (qc) {
+        checkPopulate(*qc, pgm);
+    }
+    return qc;
 }
 
 JniQoreClass* QoreJniClassMap::findCreateQoreClassInProgram(QoreString& name, const char* jpath, Class* c, QoreProgram* pgm) {
     SimpleRefHolder<Class> cls(c);
 
+    // check for an existing class without blocking
+    if (pgm) {
+        JniExternalProgramData* jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
+        if (jpc) {
+            JniQoreClass* qc = jpc->find(jpath);
+            if (qc) {
+                return qc;
+            }
+        }
+    }
+
     // we always grab the global JNI lock first because we might need to add base classes
     // while setting up the class loaded with the jni module's classloader, and we need to
     // ensure that these locks are always acquired in order
@@ -567,7 +627,7 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClassInProgram(QoreString& name, co
             throw BasicException("no Java context to create Qore class");
         }
     } else {
-        if (jni_qore_init_done) {
+        if (jni_qore_init_done.load(std::memory_order_acquire)) {
             // ensure that the jni module symbols are loaded into the new Program object
             MM.runTimeLoadModule("jni", pgm, &xsink);
             if (xsink) {
@@ -647,6 +707,8 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClass(Env& env, const char* name, Q
     JniQoreClass* rv = findInternal(jpath.c_str());
     if (rv) {
         //printd(LogLevel, "QoreJniClassMap::findCreateQoreClass() '%s': %p\n", name, rv);
+        // the class is being referenced by name; make sure that it's populated
+        checkPopulate(*rv, pgm);
         return rv;
     }
     //printd(LogLevel, "QoreJniClassMap::findCreateQoreClass() '%s' not cached\n", name);
@@ -666,7 +728,11 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClass(Env& env, const char* name, Q
 
     QoreString cname(name);
     // create the class in the correct namespace
-    return findCreateQoreClass(env, cname, jpath.c_str(), cls.release(), base, pgm);
+    rv = findCreateQoreClass(env, cname, jpath.c_str(), cls.release(), base, pgm);
+    if (rv) {
+        checkPopulate(*rv, pgm);
+    }
+    return rv;
 }
 
 JniQoreClass* QoreJniClassMap::findCreateQoreClassInBase(Env& env, QoreString& name, const char* jpath, Class* c,
@@ -675,10 +741,17 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClassInBase(Env& env, QoreString& n
 
     printd(LogLevel, "QoreJniClassMap::findCreateQoreClassInBase() looking up: '%s'\n", jpath);
 
+    // if we have the QoreClass already, then return it; this does not block
+    {
+        JniQoreClass* qc = find(jpath);
+        if (qc)
+            return qc;
+    }
+
     // we need to protect access to the default namespace and class map with a lock
     AutoLocker al(m);
 
-    // if we have the QoreClass already, then return it
+    // check again with the lock held
     {
         JniQoreClass* qc = find(jpath);
         if (qc)
@@ -775,9 +848,15 @@ JniQoreClass* QoreJniClassMap::findCreateQoreClassInBase(Env& env, QoreString& n
         // create entry for class in map
         jpc->add(jpath, new_qc.get());
 
-        // save class in namespace
+        // save class in namespace; lazily-imported classes are added when populated
         qc = new_qc.release();
-        ns->addSystemClass(qc);
+        if (static_cast<Class*>(qc->getManagedUserData())->isPopulated()
+            || !init_done.load(std::memory_order_acquire) || !jpc->getLazyImport()) {
+            ns->addSystemClass(qc);
+        } else {
+            ns->setClassHandler(jni_class_handler);
+            jpc->addPendingClass(qc, ns, pgm);
+        }
     }
 
     return qc;
@@ -831,13 +910,21 @@ JniQoreClass* QoreJniClassMap::createClassInNamespace(QoreNamespace* ns, QoreNam
 
     addSuperClasses(qc, jc, jpath, pgm, jpc);
 
-    // add methods after parents
-    if (init_done) {
-        populateQoreClass(*qc, jc, pgm);
-    }
+    // add methods after parents; with lazy imports, classes are populated when first referenced by name or when
+    // first used to wrap a Java object; see checkPopulate()
+    if (init_done.load(std::memory_order_acquire) && jpc->getLazyImport()) {
+        // the class is added to the namespace when it is populated, so that the first reference by name at parse
+        // time or runtime goes through the class handler, which populates it
+        ns->setClassHandler(jni_class_handler);
+        map.addPendingClass(qc, ns, &jns == default_jns ? nullptr : pgm);
+    } else {
+        if (init_done.load(std::memory_order_acquire)) {
+            populateQoreClass(*qc, jc, pgm);
+        }
 
-    // save class in namespace
-    ns->addSystemClass(qc);
+        // save class in namespace
+        ns->addSystemClass(qc);
+    }
 
     jpc->saveClass(*qc, jc->getJavaObjectRef());
 
@@ -946,7 +1033,49 @@ void QoreJniClassMap::addSuperClass(Env& env, JniQoreClass& qc, jni::Class* pare
     qc.addBuiltinVirtualBaseClass(pc);
 }
 
+void QoreJniClassMap::checkPopulate(JniQoreClass& qc, QoreProgram* pgm) {
+    // classes created before initialization is complete are populated in initIntern()
+    if (!init_done.load(std::memory_order_acquire)) {
+        return;
+    }
+    Class* jc = static_cast<Class*>(qc.getManagedUserData());
+    if (!jc || jc->isPopulated()) {
+        return;
+    }
+
+    AutoLocker al(m);
+    // check again with the lock held; the class may also be in the process of being populated by this thread
+    if (jc->isPopulated() || jc->isPopulating()) {
+        return;
+    }
+
+    printd(LogLevel, "QoreJniClassMap::checkPopulate() populating lazily-imported class '%s'\n", qc.getName());
+
+    if (!pgm) {
+        jni_get_context_unconditional(pgm);
+    }
+
+    // populate parent classes first so that inherited methods are available
+    {
+        QoreParentClassIterator ci(qc);
+        while (ci.next()) {
+            const JniQoreClass* pqc = dynamic_cast<const JniQoreClass*>(&ci.getParentClass());
+            if (pqc) {
+                checkPopulate(*const_cast<JniQoreClass*>(pqc), pgm);
+            }
+        }
+    }
+
+    populateQoreClass(qc, jc, pgm);
+}
+
 void QoreJniClassMap::populateQoreClass(JniQoreClass& qc, jni::Class* jc, QoreProgram* pgm) {
+    // the lock is recursive; population can recursively reference the class being populated
+    AutoLocker al(m);
+    if (!jc->setPopulating()) {
+        return;
+    }
+
     // do constructors
     doConstructors(qc, jc, pgm);
 
@@ -955,6 +1084,113 @@ void QoreJniClassMap::populateQoreClass(JniQoreClass& qc, jni::Class* jc, QorePr
 
     // do fields
     doFields(qc, jc, pgm);
+
+    // other threads only use the class without the lock once it has been fully populated
+    jc->setPopulated();
+
+    // add lazily-imported classes to their namespaces
+    for (QoreJniClassMapBase* owner : jc->takePendingOwners()) {
+        owner->commitPendingClass(jc);
+    }
+}
+
+QoreJniClassMapBase::~QoreJniClassMapBase() {
+    delete table.load(std::memory_order_relaxed);
+    for (Table* t : retired) {
+        delete t;
+    }
+    for (Entry* e : entries) {
+        delete e;
+    }
+}
+
+void QoreJniClassMapBase::add(const char* name, JniQoreClass* qc) {
+    printd(LogLevel, "QoreJniClassMapBase::add() this: %p name: %s qc: %p (%s)\n", this, name, qc, qc->getName());
+
+    // writers are serialized; readers never block
+    AutoLocker al(write_lock);
+
+#ifdef DEBUG
+    if (findInternal(name))
+        printd(0, "QoreJniClassMapBase::add() name: %s qc: %p (%s)\n", name, qc, qc->getName());
+#endif
+    assert(!findInternal(name));
+
+    Entry* e = new Entry{name, qc};
+    entries.push_back(e);
+
+    Table* t = table.load(std::memory_order_relaxed);
+    if (entries.size() * 2 <= t->mask + 1) {
+        t->insert(e);
+        return;
+    }
+
+    // publish a new table of twice the size; the old table is kept for readers that may still be using it
+    Table* new_table = new Table((t->mask + 1) * 2);
+    for (const Entry* i : entries) {
+        new_table->insert(i);
+    }
+    table.store(new_table, std::memory_order_release);
+    retired.push_back(t);
+}
+
+void QoreJniClassMapBase::getClassList(std::vector<JniQoreClass*>& cvec) const {
+    AutoLocker al(write_lock);
+    for (const Entry* e : entries) {
+        cvec.push_back(e->qc);
+    }
+}
+
+void QoreJniClassMapBase::copyClassMap(const QoreJniClassMapBase& old) {
+    AutoLocker al(old.write_lock);
+    for (const Entry* e : old.entries) {
+        add(e->name.c_str(), e->qc);
+    }
+}
+
+void QoreJniClassMapBase::addPendingClass(JniQoreClass* qc, QoreNamespace* ns, QoreProgram* pgm) {
+    Class* jc = static_cast<Class*>(qc->getManagedUserData());
+    assert(pending_map.find(jc) == pending_map.end());
+    pending_map[jc] = {qc, ns, pgm};
+    jc->addPendingOwner(this);
+}
+
+void QoreJniClassMapBase::commitPendingClass(Class* jc) {
+    pending_map_t::iterator i = pending_map.find(jc);
+    assert(i != pending_map.end());
+    PendingClass pc = i->second;
+    // the namespace owns the class once it has been added
+    pending_map.erase(i);
+
+    printd(LogLevel, "QoreJniClassMapBase::commitPendingClass() adding populated class '%s' to ns: %p '%s'\n",
+        pc.qc->getName(), pc.ns, pc.ns->getName());
+
+    if (!pc.pgm) {
+        pc.ns->addSystemClass(pc.qc);
+        return;
+    }
+
+    ExceptionSink xsink;
+    QoreExternalProgramContextHelper epch(&xsink, pc.pgm);
+    if (xsink) {
+        throw XsinkException(xsink);
+    }
+
+    // grab the Program's parse lock before manipulating namespaces
+    CurrentProgramRuntimeExternalParseContextHelper pch;
+    if (!pch) {
+        throw BasicException("could not attach to deleted Qore Program when adding a lazily-imported class");
+    }
+    pc.ns->addSystemClass(pc.qc);
+}
+
+void QoreJniClassMapBase::deletePendingClasses() {
+    AutoLocker al(QoreJniClassMap::m);
+    for (auto& i : pending_map) {
+        i.first->removePendingOwner(this);
+        delete i.second.qc;
+    }
+    pending_map.clear();
 }
 
 void QoreJniClassMap::doConstructors(JniQoreClass& qc, jni::Class* jc, QoreProgram* pgm) {
@@ -2528,6 +2764,18 @@ jobject QoreJniClassMap::getJavaClosure(const ResolvedCallReferenceNode* call) {
     }
 }
 
+jobject QoreJniClassMap::getJavaTask(const ResolvedCallReferenceNode* call) {
+    Env env;
+    LocalReference<jobject> closure = getJavaClosure(call);
+    // the task stores the program, as it can be run in threads without a Qore program context
+    QoreProgram* pgm = nullptr;
+    jni_get_context_unconditional(pgm);
+    jvalue jargs[2];
+    jargs[0].j = reinterpret_cast<jlong>(pgm);
+    jargs[1].l = closure;
+    return env.newObject(Globals::classQoreTask, Globals::ctorQoreTask, &jargs[0]).release();
+}
+
 jarray QoreJniClassMap::getJavaArray(const QoreListNode* l, jclass cls, JniExternalProgramData* jpc) {
     Env env;
 
@@ -2695,7 +2943,9 @@ JniExternalProgramData::JniExternalProgramData(const JniExternalProgramData& par
         pgm(pgm),
         classLoader(nullptr),
         override_compat_types(parent.override_compat_types),
-        compat_types(parent.compat_types) {
+        compat_types(parent.compat_types),
+        override_lazy_import(parent.override_lazy_import),
+        lazy_import(parent.lazy_import) {
     // create the classLoader and set the parent
     {
         jvalue jargs[2];
@@ -2708,7 +2958,7 @@ JniExternalProgramData::JniExternalProgramData(const JniExternalProgramData& par
     initDynamicApi(env);
 
     // copy the parent's class map to this one
-    jcmap = parent.jcmap;
+    copyClassMap(parent);
 
 #if QORE_VERSION_CODE >= 10013
     ProgramRuntimeExternalParseContextHelper pch(pgm);
@@ -2738,6 +2988,8 @@ JniExternalProgramData::~JniExternalProgramData() {
     for (auto& i : fake_cls_map) {
         delete i.second;
     }
+    // delete lazily-imported classes that were never populated
+    deletePendingClasses();
     classLoader = nullptr;
 }
 
@@ -2748,9 +3000,8 @@ void JniExternalProgramData::initDynamicApi(Env& env) {
     // make byte array
     LocalReference<jbyteArray> jbyte_code =
         env.newByteArray(java_org_qore_jni_QoreJavaDynamicApi_class_len).as<jbyteArray>();
-    for (jsize i = 0; (unsigned)i < java_org_qore_jni_QoreJavaDynamicApi_class_len; ++i) {
-        env.setByteArrayElement(jbyte_code, i, java_org_qore_jni_QoreJavaDynamicApi_class[i]);
-    }
+    env.setByteArrayRegion(jbyte_code, 0, java_org_qore_jni_QoreJavaDynamicApi_class_len,
+        java_org_qore_jni_QoreJavaDynamicApi_class);
 
     std::vector<jvalue> jargs(4);
     jargs[0].l = jname;
@@ -2833,6 +3084,8 @@ JniExternalProgramData* JniExternalProgramData::getCreateJniProgramData(QoreProg
     JniExternalProgramData* jpc = static_cast<JniExternalProgramData*>(pgm->getExternalData("jni"));
     //printd(5, "parse-cmd '%s' jpc: %p jnins: %p\n", arg.c_str(), jpc, jpc ? jpc->getJniNamespace() : nullptr);
     if (!jpc) {
+        // with background initialization, the Jni namespace is added here on first use; raises any init error
+        QoreJniClassMap::waitForInit();
 #if QORE_VERSION_CODE >= 10013
         ProgramRuntimeExternalParseContextHelper pch(pgm);
 #endif
@@ -32,18 +32,25 @@
 
 #include <set>
 #include <map>
+#include <memory>
+#include <vector>
+#include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <string>
 
 typedef std::set<std::string> strset_t;
 
 DLLLOCAL QoreClass* initJavaArrayClass(QoreNamespace& ns);
+DLLLOCAL QoreClass* initJavaFutureClass(QoreNamespace& ns);
 DLLLOCAL QoreClass* initQoreInvocationHandlerClass(QoreNamespace& ns);
 
 DLLLOCAL void init_jni_functions(QoreNamespace& ns);
 DLLLOCAL QoreClass* jni_class_handler(QoreNamespace* ns, const char* cname);
 
 DLLLOCAL extern bool jni_compat_types;
+DLLLOCAL extern bool jni_lazy_import;
 
 namespace jni {
 
@@ -77,41 +84,129 @@ class Class;
 class JniExternalProgramData;
 
 class QoreJniClassMapBase {
-protected:
-    // map of java class names (ex 'java/lang/Object') to JniQoreClass ptrs
-    typedef std::map<std::string, JniQoreClass*> jcmap_t;
-    // map of java class names (ex 'java/lang/Object') to JniQoreClass ptrs
-    jcmap_t jcmap;
-
 public:
-    DLLLOCAL void add(const char* name, JniQoreClass* qc) {
-        printd(LogLevel, "QoreJniClassMapBase::add() this: %p name: %s qc: %p (%s)\n", this, name, qc, qc->getName());
+    DLLLOCAL QoreJniClassMapBase() : table(new Table(InitialTableSize)) {
+    }
 
-#ifdef DEBUG
-        if (jcmap.find(name) != jcmap.end())
-            printd(0, "QoreJniClassMapBase::add() name: %s qc: %p (%s)\n", name, qc, qc->getName());
-#endif
+    DLLLOCAL ~QoreJniClassMapBase();
 
-        assert(jcmap.find(name) == jcmap.end());
-        jcmap[name] = qc;
-    }
+    DLLLOCAL void add(const char* name, JniQoreClass* qc);
 
     // accepts either a dotted name (ex: "java.lang.Object)") or an internal name ("java/lang/Object") as argument
     DLLLOCAL JniQoreClass* find(const char* jpath) const {
         if (strchr(jpath, '.')) {
             QoreString str(jpath);
             str.replaceAll(".", "/");
-            jcmap_t::const_iterator i = jcmap.find(str.c_str());
-            return i == jcmap.end() ? nullptr : i->second;
+            return findInternal(str.c_str());
         }
-        jcmap_t::const_iterator i = jcmap.find(jpath);
-        return i == jcmap.end() ? nullptr : i->second;
+        return findInternal(jpath);
     }
 
-    // accepts an internal name as argument (ex: "java/lang/Object")
+    // accepts an internal name as argument (ex: "java/lang/Object"); does not block or allocate memory
     DLLLOCAL JniQoreClass* findInternal(const char* jpath) const {
-        jcmap_t::const_iterator i = jcmap.find(jpath);
-        return i == jcmap.end() ? nullptr : i->second;
+        const Table* t = table.load(std::memory_order_acquire);
+        for (size_t i = hash(jpath) & t->mask; ; i = (i + 1) & t->mask) {
+            const Entry* e = t->slots[i].load(std::memory_order_acquire);
+            if (!e) {
+                return nullptr;
+            }
+            if (e->name == jpath) {
+                return e->qc;
+            }
+        }
+    }
+
+    // saves a lazily-imported class that is only added to the given namespace when it is populated
+    /** Until then, the class is resolved by name through the class handler, which populates it.  Must be called
+        with the class map lock held.
+
+        @param qc the class; the class map holds the class until it is added to the namespace
+        @param ns the namespace to add the class to
+        @param pgm the program that owns the namespace; nullptr for the default Jni namespace
+    */
+    DLLLOCAL void addPendingClass(JniQoreClass* qc, QoreNamespace* ns, QoreProgram* pgm);
+
+    // adds the class for the given Java class saved with addPendingClass() to its namespace
+    /** Must be called with the class map lock held after the class has been populated
+    */
+    DLLLOCAL void commitPendingClass(Class* jc);
+
+protected:
+    // returns all classes in the map
+    DLLLOCAL void getClassList(std::vector<JniQoreClass*>& cvec) const;
+
+    // copies all classes from the given map to this map
+    DLLLOCAL void copyClassMap(const QoreJniClassMapBase& old);
+
+    // deletes lazily-imported classes that were never populated and therefore never added to a namespace
+    DLLLOCAL void deletePendingClasses();
+
+private:
+    // a lazily-imported class and the namespace it is added to when it is populated
+    struct PendingClass {
+        JniQoreClass* qc;
+        QoreNamespace* ns;
+        // the program that owns the namespace; nullptr for the default Jni namespace
+        QoreProgram* pgm;
+    };
+    // map of Java classes to lazily-imported classes to be added to a namespace when populated; protected by the
+    // class map lock
+    typedef std::map<Class*, PendingClass> pending_map_t;
+    pending_map_t pending_map;
+
+    // class map entry; entries are only deleted with the map
+    struct Entry {
+        // internal name of the Java class (ex 'java/lang/Object')
+        std::string name;
+        JniQoreClass* qc;
+    };
+
+    // open-addressing hash table of class map entries; never more than half full, so every probe sequence ends
+    // with an empty slot
+    struct Table {
+        size_t mask;
+        std::atomic<const Entry*>* slots;
+
+        DLLLOCAL Table(size_t size) : mask(size - 1), slots(new std::atomic<const Entry*>[size]) {
+            for (size_t i = 0; i < size; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        DLLLOCAL ~Table() {
+            delete [] slots;
+        }
+
+        // adds an entry; a reader sees either an empty slot or the complete entry
+        DLLLOCAL void insert(const Entry* e) {
+            size_t i = hash(e->name.c_str()) & mask;
+            while (slots[i].load(std::memory_order_relaxed)) {
+                i = (i + 1) & mask;
+            }
+            slots[i].store(e, std::memory_order_release);
+        }
+    };
+
+    // the initial number of slots in the hash table; must be a power of 2
+    static constexpr size_t InitialTableSize = 256;
+
+    // the current hash table; lookups take no locks
+    std::atomic<Table*> table;
+    // all entries in the order they were added; protected by write_lock
+    std::vector<Entry*> entries;
+    // tables replaced by a larger table, which readers may still be using; deleted with the map, as they only use
+    // as much memory as the current table in total
+    std::vector<Table*> retired;
+    // serializes updates to the class map
+    mutable QoreThreadLock write_lock;
+
+    // FNV-1a hash of the class name
+    DLLLOCAL static size_t hash(const char* name) {
+        size_t h = 2166136261u;
+        for (; *name; ++name) {
+            h = (h ^ static_cast<unsigned char>(*name)) * 16777619u;
+        }
+        return h;
     }
 };
 
@@ -119,7 +214,27 @@ class QoreJniClassMap : public QoreJniClassMapBase {
 public:
     static QoreRecursiveThreadLock m;
 
-    DLLLOCAL void init(QoreProgram* pgm, bool already_initialized);
+    //! initializes the class map; if background is true, initialization is performed in a background thread
+    /** @return true if initialization continues in a background thread
+    */
+    DLLLOCAL bool init(QoreProgram* pgm, bool already_initialized, bool background = false);
+
+    //! waits for background initialization to complete; throws an exception if initialization failed
+    DLLLOCAL static void waitForInit() {
+        if (init_pending.load(std::memory_order_acquire) || init_failed) {
+            waitForInitIntern();
+        }
+    }
+
+    //! returns true if the class map has been initialized successfully; does not block
+    DLLLOCAL static bool isInitComplete() {
+        return !init_pending.load(std::memory_order_acquire) && !init_failed;
+    }
+
+    //! returns true if the class map is or was initialized in a background thread
+    DLLLOCAL static bool isBackgroundInit() {
+        return init_background;
+    }
 
     DLLLOCAL void destroy(ExceptionSink& xsink);
 
@@ -139,6 +254,8 @@ public:
 
     DLLLOCAL jobject getJavaObject(const QoreObject* o);
     DLLLOCAL jobject getJavaClosure(const ResolvedCallReferenceNode* call);
+    //! returns a Java QoreTask object for the closure, which implements Runnable, Callable and Supplier
+    DLLLOCAL jobject getJavaTask(const ResolvedCallReferenceNode* call);
 
     DLLLOCAL jarray getJavaArray(const QoreListNode* l, jclass cls, JniExternalProgramData* jpc = nullptr);
 
@@ -173,6 +290,9 @@ public:
 
     DLLLOCAL static LocalReference<jclass> getPrimitiveType(qore_type_t t);
 
+    // populates the given class and its parents if they were created without methods and members (lazy imports)
+    DLLLOCAL void checkPopulate(JniQoreClass& qc, QoreProgram* pgm);
+
 protected:
     // map of java class names to const QoreTypeInfo ptrs
     typedef std::map<const std::string, const QoreTypeInfo*> jtmap_t;
@@ -221,7 +341,7 @@ protected:
 
 private:
     // initialization flag
-    static bool init_done;
+    static std::atomic<bool> init_done;
 
     DLLLOCAL void initIntern(QoreProgram* pgm);
 
@@ -229,21 +349,32 @@ private:
 
     DLLLOCAL Class* loadProgramClass(Env& env, const char* name, JniExternalProgramData* jpc);
 
-#ifdef JNI_INIT_BACKGROUND
+    // background initialization
     static std::mutex init_mutex;
     static std::condition_variable init_cond;
+    // set while background initialization is in progress
+    static std::atomic<bool> init_pending;
+    // set if background initialization failed; the error is raised at every access
+    static bool init_failed;
+    // set if the class map is initialized in a background thread; Jni namespaces are then added on first use
+    static bool init_background;
+    static std::string init_err;
+    static std::string init_desc;
 
     DLLLOCAL static void staticInitBackground(ExceptionSink* xsink, void* pgm);
 
+    DLLLOCAL static void waitForInitIntern();
+
     class InitSignaler {
     public:
         DLLLOCAL ~InitSignaler() {
-            init_cond.notify_one();
+            {
+                std::lock_guard<std::mutex> init_guard(init_mutex);
+                init_pending.store(false, std::memory_order_release);
+            }
+            init_cond.notify_all();
         }
-
-        std::lock_guard<std::mutex> init_guard();
     };
-#endif
 };
 
 extern QoreJniClassMap qjcm;
@@ -345,6 +476,15 @@ public:
         return override_compat_types ? compat_types : jni_compat_types;
     }
 
+    DLLLOCAL void overrideLazyImport(bool lazy_import) {
+        override_lazy_import = true;
+        this->lazy_import = lazy_import;
+    }
+
+    DLLLOCAL bool getLazyImport() const {
+        return override_lazy_import ? lazy_import : jni_lazy_import;
+    }
+
     DLLLOCAL void setSaveObjectCallback(const ResolvedCallReferenceNode* save_object_callback) {
         if (this->save_object_callback) {
             this->save_object_callback->deref(nullptr);
@@ -453,6 +593,10 @@ protected:
     bool override_compat_types = false;
     // compat-types values
     bool compat_types = false;
+    // override lazy-import
+    bool override_lazy_import = false;
+    // lazy-import value
+    bool lazy_import = false;
 
     // injected module set
     strset_t injected_module_set;
@@ -33,35 +33,34 @@ QoreJniFunctionalInterface::QoreJniFunctionalInterface(jobject obj) : obj(Global
     assert(src_pgm);
     Env env;
 
-    cls = new Class(env.callObjectMethod(obj, Globals::methodObjectGetClass, nullptr).as<jclass>());
-    LocalReference<jobjectArray> methods = cls->getDeclaredMethods();
+    // find the call() method of a Qore closure marker or the single abstract method of a functional interface; the
+    // method is cached for each class in Java
+    LocalReference<jclass> ocls = env.getObjectClass(obj);
+    jvalue jarg;
+    jarg.l = ocls;
+    LocalReference<jobject> m = env.callStaticObjectMethod(Globals::classQoreJavaApi,
+        Globals::methodQoreJavaApiGetFunctionalMethod, &jarg);
 
-    // find first "call" method in the class
-    for (jsize i = 0, num_methods = env.getArrayLength(methods); i < num_methods; ++i) {
-        // get Method object
-        LocalReference<jobject> m = env.getObjectArrayElement(methods, i);
-        LocalReference<jstring> mName = env.callObjectMethod(m, Globals::methodMethodGetName, nullptr).as<jstring>();
-        Env::GetStringUtfChars mcn(env, mName);
-        if (!strcmp(mcn.c_str(), "call")) {
-            method = new BaseMethod(m, *cls);
-            break;
-        }
-    }
-
-    if (!method) {
-        LocalReference<jstring> clsName = env.callObjectMethod(cls->getJavaObject(), Globals::methodClassGetName,
+    if (!m) {
+        LocalReference<jstring> clsName = env.callObjectMethod(ocls, Globals::methodClassGetName,
             nullptr).as<jstring>();
         Env::GetStringUtfChars cName(env, clsName);
 
-        QoreStringMaker str("Java class '%s' for Java object to be used as a Qore closure has no call() method to " \
-            "be used as a Qore closure", cName.c_str());
+        QoreStringMaker str("Java class '%s' for Java object to be used as a Qore closure has no call() method and " \
+            "does not implement a functional interface", cName.c_str());
         throw BasicException(str.c_str());
     }
+
+    cls = new Class(env.callObjectMethod(m, Globals::methodMethodGetDeclaringClass, nullptr).as<jclass>());
+    method = new BaseMethod(env, m, *cls);
+    jpc = static_cast<JniExternalProgramData*>(src_pgm->getExternalData("jni"));
 }
 
 QoreValue QoreJniFunctionalInterface::execValue(const QoreListNode* args, ExceptionSink* xsink) const {
     try {
-        ReferenceHolder<QoreListNode> evaluated_args(args ? args->evalList(xsink) : nullptr, xsink);
+        // arguments only have to be evaluated if they contain expressions; values are passed as-is
+        ReferenceHolder<QoreListNode> evaluated_args(args && args->needs_eval() ? args->evalList(xsink) : nullptr,
+            xsink);
         if (*xsink) {
             return QoreValue();
         }
@@ -74,10 +73,10 @@ QoreValue QoreJniFunctionalInterface::execValue(const QoreListNode* args, Except
         // make sure that the Qore exception stack is populated correctly in case a Qore exception is thrown
         // from the Java code about to be called below
         QoreJniStackLocationHelper slh;
-        // make the call
-        return method->isStatic()
-            ? method->invokeStatic(*evaluated_args, src_pgm)
-            : method->invoke(obj, *evaluated_args, src_pgm);
+        // make the call; the method is an interface method, so it can be called directly with JNI without boxing
+        // the arguments for the dynamic API
+        Env env;
+        return method->invokeDirect(env, obj, evaluated_args ? *evaluated_args : args, src_pgm, jpc);
     } catch (jni::Exception& e) {
         e.convert(xsink);
         return QoreValue();
@@ -56,5 +56,6 @@ private:
     SimpleRefHolder<Class> cls;
     SimpleRefHolder<BaseMethod> method;
     QoreProgram* src_pgm;
+    JniExternalProgramData* jpc;
 };
 }
\ No newline at end of file
@@ -243,7 +243,14 @@ jobject QoreToJava::toObject(Env& env, const QoreValue& value, jclass cls, JniEx
         case NT_RUNTIME_CLOSURE:
         case NT_FUNCREF: {
             const ResolvedCallReferenceNode* call = value.get<const ResolvedCallReferenceNode>();
-            javaObjectRef = qjcm.getJavaClosure(call);
+            // use a task object for Runnable, Callable and Supplier arguments, so that closures can be passed to
+            // Java executors
+            if (cls && !env.isAssignableFrom(Globals::classQoreClosure, cls)
+                && env.isAssignableFrom(Globals::classQoreTask, cls)) {
+                javaObjectRef = qjcm.getJavaTask(call);
+            } else {
+                javaObjectRef = qjcm.getJavaClosure(call);
+            }
             break;
         }
         case NT_BINARY: {
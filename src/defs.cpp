@@ -37,40 +37,74 @@ static const char* this_file = q_basenameptr(__FILE__);
 
 thread_local QoreThreadAttacher qoreThreadAttacher;
 
+std::atomic<bool> jni_sticky_thread_attach(false);
+
+void QoreThreadAttacher::detachAtThreadExit() {
+    // releasing Qore thread-local data can release Java references, but the JVM may already have detached the
+    // thread if it is a Java thread
+    Jvm::refreshEnv();
+    detach();
+}
+
 class JniCallStack : public QoreCallStack {
 public:
-    DLLLOCAL JniCallStack(jobject throwable, QoreExternalProgramLocationWrapper& loc) {
+    //! converts the stack trace of the throwable; if desc is not null, the description of the throwable is added
+    /** the description and the stack trace are retrieved with a single call to Java instead of several JNI calls
+        per frame; the number of frames is limited by QoreJavaApi.setExceptionStackDepth()
+    */
+    DLLLOCAL JniCallStack(jobject throwable, QoreExternalProgramLocationWrapper& loc, QoreString* desc = nullptr) {
+        // not available if the module is not fully initialized
+        if (!Globals::methodQoreJavaApiGetThrowableInfo) {
+            return;
+        }
+
         Env env;
 
         try {
-            LocalReference<jobjectArray> jstack = env.callObjectMethod(throwable, Globals::methodThrowableGetStackTrace, nullptr).as<jobjectArray>();
-            if (jstack) {
-                QoreString code;
-                for (jsize i = 0, e = env.getArrayLength(jstack); i < e; ++i) {
-                    LocalReference<jobject> jste = env.getObjectArrayElement(jstack, i);
-
-                    LocalReference<jstring> jcls = env.callObjectMethod(jste, Globals::methodStackTraceElementGetClassName, nullptr).as<jstring>();
-                    jni::Env::GetStringUtfChars cname(env, jcls);
-                    LocalReference<jstring> jmethod = env.callObjectMethod(jste, Globals::methodStackTraceElementGetMethodName, nullptr).as<jstring>();
-                    jni::Env::GetStringUtfChars mname(env, jmethod);
-                    LocalReference<jstring> jfilename = env.callObjectMethod(jste, Globals::methodStackTraceElementGetFileName, nullptr).as<jstring>();
-                    jni::Env::GetStringUtfChars file(env, jfilename);
-                    jint line = env.callIntMethod(jste, Globals::methodStackTraceElementGetLineNumber, nullptr);
-                    jboolean native = env.callBooleanMethod(jste, Globals::methodStackTraceElementIsNativeMethod, nullptr);
-
-                    printd(LogLevel, "JniCallStack::JniCallStack() adding %s\n", code.c_str());
-                    if (!i) {
-                        loc.set(file.c_str(), line, line, nullptr, 0, "Java");
-                    } else {
-                        add(native ? CT_BUILTIN : CT_USER, file.c_str(), line, line, code.c_str(), "Java");
-                    }
-
-                    code.clear();
-                    code.sprintf("%s.%s", cname.c_str(), mname.c_str());
-                }
-                if (!code.empty()) {
-                    add(CT_BUILTIN, this_file, __LINE__, __LINE__, code.c_str(), "c++");
+            jvalue jarg;
+            jarg.l = throwable;
+            LocalReference<jobjectArray> jinfo = env.callStaticObjectMethod(Globals::classQoreJavaApi,
+                Globals::methodQoreJavaApiGetThrowableInfo, &jarg).as<jobjectArray>();
+
+            if (desc) {
+                LocalReference<jstring> jdesc = env.getObjectArrayElement(jinfo, 0).as<jstring>();
+                jni::Env::GetStringUtfChars str(env, jdesc);
+                desc->concat(str.c_str());
+            }
+
+            LocalReference<jobjectArray> jcalls = env.getObjectArrayElement(jinfo, 1).as<jobjectArray>();
+            LocalReference<jobjectArray> jfiles = env.getObjectArrayElement(jinfo, 2).as<jobjectArray>();
+            LocalReference<jintArray> jlines = env.getObjectArrayElement(jinfo, 3).as<jintArray>();
+
+            // the last element of the line array is the number of omitted frames
+            jsize len = env.getArrayLength(jcalls);
+            std::vector<jint> lines(len + 1);
+            env.getIntArrayRegion(jlines, 0, len + 1, lines.data());
+
+            QoreString code;
+            for (jsize i = 0; i < len; ++i) {
+                LocalReference<jstring> jcall = env.getObjectArrayElement(jcalls, i).as<jstring>();
+                jni::Env::GetStringUtfChars call(env, jcall);
+                LocalReference<jstring> jfile = env.getObjectArrayElement(jfiles, i).as<jstring>();
+                jni::Env::GetStringUtfChars file(env, jfile);
+                jint line = lines[i];
+
+                printd(LogLevel, "JniCallStack::JniCallStack() adding %s\n", code.c_str());
+                if (!i) {
+                    loc.set(file.c_str(), line, line, nullptr, 0, "Java");
+                } else {
+                    // Java reports -2 as the line number of native methods
+                    add(line == -2 ? CT_BUILTIN : CT_USER, file.c_str(), line, line, code.c_str(), "Java");
                 }
+
+                code.clear();
+                code.concat(call.c_str());
+            }
+            if (lines[len]) {
+                QoreStringMaker omitted("<%d more Java frames>", (int)lines[len]);
+                add(CT_BUILTIN, omitted.c_str(), -1, -1, code.c_str(), "Java");
+            } else if (!code.empty()) {
+                add(CT_BUILTIN, this_file, __LINE__, __LINE__, code.c_str(), "c++");
             }
         } catch (jni::Exception& e) {
             e.ignore();
@@ -135,6 +169,36 @@ QoreStringNode* JavaException::toString(bool clear) const {
 
     SimpleRefHolder<QoreStringNode> desc(new QoreStringNode(QCS_UTF8));
 
+    // describe the whole cause chain with a single call to Java if possible
+    if (Globals::methodQoreJavaApiGetThrowableDescription) {
+        // Java cannot be called while an exception is pending
+        if (!clear) {
+            env->ExceptionClear();
+        }
+        jvalue jargs[2];
+        jargs[0].l = throwable;
+        jargs[1].z = JNI_TRUE;
+        LocalReference<jstring> jdesc = static_cast<jstring>(env->CallStaticObjectMethodA(Globals::classQoreJavaApi,
+            Globals::methodQoreJavaApiGetThrowableDescription, &jargs[0]));
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+        } else if (jdesc != nullptr) {
+            const char* chars = env->GetStringUTFChars(jdesc, nullptr);
+            if (!chars) {
+                env->ExceptionClear();
+            } else {
+                desc->concat(chars);
+                env->ReleaseStringUTFChars(jdesc, chars);
+            }
+        }
+        if (!clear) {
+            env->Throw(throwable);
+        }
+        if (!desc->empty()) {
+            return desc.release();
+        }
+    }
+
     while (true) {
         LocalReference<jstring> excName = static_cast<jstring>(env->CallObjectMethod(env->GetObjectClass(throwable),
             Globals::methodClassGetName));
@@ -226,45 +290,48 @@ void JavaException::convert(ExceptionSink* xsink) {
         return;
     }
 
-    LocalReference<jstring> excName = static_cast<jstring>(env->CallObjectMethod(env->GetObjectClass(throwable),
-        Globals::methodClassGetName));
-    if (env->ExceptionCheck()) {
-        env->ExceptionClear();
-        xsink->raiseException("JNI-ERROR", "Unable to get exception class name - another exception thrown");
-        return;
-    }
+    // add Java call stack to Qore call stack; the description is retrieved with the call stack
+    QoreExternalProgramLocationWrapper loc;
+    SimpleRefHolder<QoreStringNode> desc(new QoreStringNode(QCS_UTF8));
+    JniCallStack stack(throwable, loc, *desc);
 
-    const char* chars = env->GetStringUTFChars(excName, nullptr);
-    if (!chars) {
-        env->ExceptionClear();
-        xsink->raiseException("JNI-ERROR", "Unable to get exception class name - GetStringUTFChars() failed");
-        return;
-    }
-    SimpleRefHolder<QoreStringNode> desc(new QoreStringNode(chars, QCS_UTF8));
-    env->ReleaseStringUTFChars(excName, chars);
+    if (desc->empty()) {
+        LocalReference<jstring> excName = static_cast<jstring>(env->CallObjectMethod(env->GetObjectClass(throwable),
+            Globals::methodClassGetName));
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+            xsink->raiseException("JNI-ERROR", "Unable to get exception class name - another exception thrown");
+            return;
+        }
 
-    LocalReference<jstring> msg = static_cast<jstring>(env->CallObjectMethod(throwable,
-        Globals::methodThrowableGetMessage));
-    if (env->ExceptionCheck()) {
-        env->ExceptionClear();
-    } else if (msg != nullptr) {
-        desc->concat(": ");
-        chars = env->GetStringUTFChars(msg, nullptr);
+        const char* chars = env->GetStringUTFChars(excName, nullptr);
         if (!chars) {
             env->ExceptionClear();
-        } else {
-            desc->concat(chars);
-            env->ReleaseStringUTFChars(msg, chars);
+            xsink->raiseException("JNI-ERROR", "Unable to get exception class name - GetStringUTFChars() failed");
+            return;
+        }
+        desc->concat(chars);
+        env->ReleaseStringUTFChars(excName, chars);
+
+        LocalReference<jstring> msg = static_cast<jstring>(env->CallObjectMethod(throwable,
+            Globals::methodThrowableGetMessage));
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+        } else if (msg != nullptr) {
+            desc->concat(": ");
+            chars = env->GetStringUTFChars(msg, nullptr);
+            if (!chars) {
+                env->ExceptionClear();
+            } else {
+                desc->concat(chars);
+                env->ReleaseStringUTFChars(msg, chars);
+            }
         }
     }
 
     QoreProgram* pgm = nullptr;
     jni_get_context_unconditional(pgm);
 
-    // add Java call stack to Qore call stack
-    QoreExternalProgramLocationWrapper loc;
-    JniCallStack stack(throwable, loc);
-
     LocalReference<jclass> tcls(env->GetObjectClass(throwable));
     {
         Env jenv(env);
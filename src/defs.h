@@ -36,6 +36,7 @@
 #include "jni.h"
 
 #include <stdarg.h>
+#include <atomic>
 #include <memory>
 
 namespace jni {
@@ -239,7 +240,8 @@ public:
 
     DLLLOCAL ~QoreThreadAttacher() {
         if (attached) {
-            detach();
+            // only the thread-local attacher can still be attached here, when its thread terminates
+            detachAtThreadExit();
         }
     }
 
@@ -282,13 +284,30 @@ private:
         q_deregister_foreign_thread();
         attached = false;
     }
+
+    DLLLOCAL void detachAtThreadExit();
 };
 
+//! attaches threads to Qore until they terminate; detached when the thread terminates
+extern thread_local QoreThreadAttacher qoreThreadAttacher;
+
+//! if true, threads calling Qore from Java stay attached to Qore until they terminate
+DLLLOCAL extern std::atomic<bool> jni_sticky_thread_attach;
+
 // class that serves to attach a thread to Qore if not already attached
 // if attached in the constructor, then it will detach in the destructor
 class QoreThreadAttachHelper {
 public:
     DLLLOCAL void attach() {
+        attach(jni_sticky_thread_attach.load(std::memory_order_relaxed));
+    }
+
+    DLLLOCAL void attach(bool sticky) {
+        // with sticky attachment, the thread stays attached until it terminates
+        if (sticky) {
+            qoreThreadAttacher.attach();
+            return;
+        }
         attached = !attacher.attach();
     }
 
@@ -303,8 +322,6 @@ private:
     bool attached = false;
 };
 
-extern thread_local QoreThreadAttacher qoreThreadAttacher;
-
 } // namespace jni
 
 extern "C" DLLEXPORT int jni_module_import(ExceptionSink* xsink, QoreProgram* pgm, const char* import);
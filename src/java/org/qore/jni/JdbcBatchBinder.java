@@ -0,0 +1,243 @@
+/*
+    JdbcBatchBinder.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.math.BigDecimal;
+import java.sql.PreparedStatement;
+import java.sql.SQLException;
+import java.sql.Timestamp;
+import java.sql.Types;
+
+//! Binds column arrays to a JDBC prepared statement as a batch
+/** Used by the jdbc DBI driver for array binds so that rows can be bound with a single JNI call instead of one
+    call per value and row.
+
+    Each parameter is described by a bind type and a value array; integer, floating-point, and boolean parameters
+    also have a null mask.  Value arrays with a single element are used for all rows (for non-array arguments).
+
+    The rows are staged when the statement's arguments are bound and are only bound to the statement and added to
+    its batch when the statement is executed, so that the driver can execute large batches in sub-batches with the
+    same error handling as any other execution.
+
+    @since 2.4
+ */
+class JdbcBatchBinder {
+    // bind types; must match JdbcBindType in QoreJdbcStatement.h
+    public static final int NULL = 0;
+    //! long[]
+    public static final int LONG = 1;
+    //! double[]
+    public static final int DOUBLE = 2;
+    //! boolean[]
+    public static final int BOOLEAN = 3;
+    //! String[]
+    public static final int STRING = 4;
+    //! byte[][]
+    public static final int BYTES = 5;
+    //! long[] with microseconds since the epoch
+    public static final int TIMESTAMP = 6;
+    //! String[] with decimal number strings
+    public static final int NUMBER = 7;
+
+    private final int[] types;
+    private final Object[] values;
+    private final Object[] nulls;
+
+    //! stages the given column arrays
+    /** @param types the bind type for each parameter
+        @param values the value array for each parameter
+        @param nulls the null mask for each parameter; may be null or contain null elements
+     */
+    public JdbcBatchBinder(int[] types, Object[] values, Object[] nulls) {
+        this.types = types;
+        this.values = values;
+        this.nulls = nulls;
+    }
+
+    //! binds the given rows and adds them to the statement's batch
+    /** @param stmt the statement
+        @param start the first row to bind
+        @param end the row after the last row to bind
+     */
+    public void bind(PreparedStatement stmt, int start, int end) throws SQLException {
+        for (int r = start; r < end; ++r) {
+            for (int c = 0; c < types.length; ++c) {
+                int col = c + 1;
+                Object v = values[c];
+                boolean[] n = nulls == null ? null : (boolean[])nulls[c];
+                switch (types[c]) {
+                    case LONG: {
+                        long[] a = (long[])v;
+                        int i = a.length == 1 ? 0 : r;
+                        if (n != null && n[i]) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            setLong(stmt, col, a[i]);
+                        }
+                        break;
+                    }
+                    case DOUBLE: {
+                        double[] a = (double[])v;
+                        int i = a.length == 1 ? 0 : r;
+                        if (n != null && n[i]) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            stmt.setDouble(col, a[i]);
+                        }
+                        break;
+                    }
+                    case BOOLEAN: {
+                        boolean[] a = (boolean[])v;
+                        int i = a.length == 1 ? 0 : r;
+                        if (n != null && n[i]) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            stmt.setBoolean(col, a[i]);
+                        }
+                        break;
+                    }
+                    case TIMESTAMP: {
+                        long[] a = (long[])v;
+                        int i = a.length == 1 ? 0 : r;
+                        if (n != null && n[i]) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            long us = a[i];
+                            Timestamp ts = new Timestamp(Math.floorDiv(us, 1000000L) * 1000L);
+                            ts.setNanos((int)Math.floorMod(us, 1000000L) * 1000);
+                            stmt.setTimestamp(col, ts);
+                        }
+                        break;
+                    }
+                    case STRING: {
+                        String[] a = (String[])v;
+                        String s = a[a.length == 1 ? 0 : r];
+                        if (s == null) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            stmt.setString(col, s);
+                        }
+                        break;
+                    }
+                    case NUMBER: {
+                        String[] a = (String[])v;
+                        String s = a[a.length == 1 ? 0 : r];
+                        if (s == null) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            stmt.setBigDecimal(col, new BigDecimal(s));
+                        }
+                        break;
+                    }
+                    case BYTES: {
+                        Object[] a = (Object[])v;
+                        byte[] b = (byte[])a[a.length == 1 ? 0 : r];
+                        if (b == null) {
+                            stmt.setNull(col, Types.NULL);
+                        } else {
+                            stmt.setBytes(col, b);
+                        }
+                        break;
+                    }
+                    default:
+                        stmt.setNull(col, Types.NULL);
+                        break;
+                }
+            }
+            stmt.addBatch();
+        }
+    }
+
+    //! returns the values of a column as JDBC objects for use with Connection.createArrayOf()
+    /** @param type the bind type
+        @param values the value array
+        @param nulls the null mask for integer, floating-point, boolean, and timestamp values; may be null
+
+        @return an array of the column's values; NULL values are returned as null elements
+     */
+    public static Object[] toArray(int type, Object values, boolean[] nulls) {
+        switch (type) {
+            case LONG: {
+                long[] a = (long[])values;
+                Long[] rv = new Long[a.length];
+                for (int i = 0; i < a.length; ++i) {
+                    rv[i] = nulls != null && nulls[i] ? null : a[i];
+                }
+                return rv;
+            }
+            case DOUBLE: {
+                double[] a = (double[])values;
+                Double[] rv = new Double[a.length];
+                for (int i = 0; i < a.length; ++i) {
+                    rv[i] = nulls != null && nulls[i] ? null : a[i];
+                }
+                return rv;
+            }
+            case BOOLEAN: {
+                boolean[] a = (boolean[])values;
+                Boolean[] rv = new Boolean[a.length];
+                for (int i = 0; i < a.length; ++i) {
+                    rv[i] = nulls != null && nulls[i] ? null : a[i];
+                }
+                return rv;
+            }
+            case TIMESTAMP: {
+                long[] a = (long[])values;
+                Timestamp[] rv = new Timestamp[a.length];
+                for (int i = 0; i < a.length; ++i) {
+                    if (nulls == null || !nulls[i]) {
+                        rv[i] = new Timestamp(Math.floorDiv(a[i], 1000000L) * 1000L);
+                        rv[i].setNanos((int)Math.floorMod(a[i], 1000000L) * 1000);
+                    }
+                }
+                return rv;
+            }
+            case NUMBER: {
+                String[] a = (String[])values;
+                BigDecimal[] rv = new BigDecimal[a.length];
+                for (int i = 0; i < a.length; ++i) {
+                    rv[i] = a[i] == null ? null : new BigDecimal(a[i]);
+                }
+                return rv;
+            }
+            case STRING:
+            case BYTES:
+                return (Object[])values;
+            default:
+                return values == null ? new Object[0] : (Object[])values;
+        }
+    }
+
+    // uses the smallest integer type for the value, like single-value binds
+    private static void setLong(PreparedStatement stmt, int col, long v) throws SQLException {
+        if (v <= Byte.MAX_VALUE && v >= Byte.MIN_VALUE) {
+            stmt.setByte(col, (byte)v);
+        } else if (v <= Short.MAX_VALUE && v >= Short.MIN_VALUE) {
+            stmt.setShort(col, (short)v);
+        } else if (v <= Integer.MAX_VALUE && v >= Integer.MIN_VALUE) {
+            stmt.setInt(col, (int)v);
+        } else {
+            stmt.setLong(col, v);
+        }
+    }
+}
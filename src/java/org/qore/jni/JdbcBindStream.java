@@ -0,0 +1,118 @@
+/*
+    JdbcBindStream.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.ByteBuffer;
+
+//! Provides %Qore binary values and %Qore \c InputStream objects to JDBC drivers as a Java \c InputStream
+/** Used by the jdbc DBI driver to bind large values with \c PreparedStatement.setBinaryStream().
+
+    Binary values are read directly from the %Qore value's memory through a direct \c ByteBuffer, so the value is not
+    copied to the Java heap; \c InputStream objects are read by calling their \c read() method.
+
+    The driver calls detach() after the statement has been executed, after which the stream returns no more data,
+    as the %Qore value may no longer be valid.
+
+    @since 2.4
+ */
+class JdbcBindStream extends InputStream {
+    private ByteBuffer buf;
+    private QoreObject obj;
+    private byte[] chunk;
+    private int chunkPos;
+
+    //! creates the stream for a direct buffer referencing a %Qore binary value
+    public JdbcBindStream(ByteBuffer buf) {
+        this.buf = buf;
+    }
+
+    //! creates the stream for a %Qore \c InputStream object
+    public JdbcBindStream(QoreObject obj) {
+        this.obj = obj;
+    }
+
+    @Override
+    public synchronized int read() throws IOException {
+        byte[] b = new byte[1];
+        int rc = read(b, 0, 1);
+        return rc < 0 ? -1 : (b[0] & 0xff);
+    }
+
+    @Override
+    public synchronized int read(byte[] b, int off, int len) throws IOException {
+        if (len == 0) {
+            return 0;
+        }
+        if (buf != null) {
+            if (!buf.hasRemaining()) {
+                return -1;
+            }
+            len = Math.min(len, buf.remaining());
+            buf.get(b, off, len);
+            return len;
+        }
+        if (obj == null) {
+            return -1;
+        }
+        // return any data left over from the last read first
+        if (chunk == null || chunkPos == chunk.length) {
+            try {
+                chunk = (byte[])obj.callMethod("read", len);
+            } catch (IOException e) {
+                throw e;
+            } catch (Throwable e) {
+                throw new IOException(e);
+            }
+            chunkPos = 0;
+            if (chunk == null) {
+                obj.release();
+                obj = null;
+                return -1;
+            }
+        }
+        len = Math.min(len, chunk.length - chunkPos);
+        System.arraycopy(chunk, chunkPos, b, off, len);
+        chunkPos += len;
+        return len;
+    }
+
+    @Override
+    public synchronized int available() {
+        if (buf != null) {
+            return buf.remaining();
+        }
+        return chunk == null ? 0 : chunk.length - chunkPos;
+    }
+
+    //! releases the %Qore value; no more data is returned after this call
+    public synchronized void detach() {
+        buf = null;
+        if (obj != null) {
+            obj.release();
+            obj = null;
+        }
+        chunk = null;
+    }
+}
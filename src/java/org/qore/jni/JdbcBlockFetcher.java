@@ -0,0 +1,195 @@
+/*
+    JdbcBlockFetcher.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.sql.ResultSet;
+import java.sql.ResultSetMetaData;
+import java.sql.SQLException;
+import java.sql.Timestamp;
+
+//! Reads blocks of rows from a JDBC result set into column arrays
+/** Used by the jdbc DBI driver so that whole blocks of rows can be retrieved with a single JNI call to fetch()
+    and a few array copies per column instead of one call per row and cell.
+
+    Integer and boolean columns are stored in \c long arrays, floating-point columns in \c double arrays, both with a
+    separate null mask; all other columns are stored in \c Object arrays, where string, binary, and timestamp columns
+    hold \c String, \c byte[], and \c String values respectively, LOB columns fetched as streams hold
+    JdbcLobStream objects, and all other columns hold the value returned by \c ResultSet.getObject().
+
+    @since 2.4
+ */
+class JdbcBlockFetcher {
+    // fetch types; must match JdbcFetchType in QoreJdbcStatement.h
+    public static final int OBJECT = 0;
+    public static final int LONG = 1;
+    public static final int DOUBLE = 2;
+    public static final int BOOLEAN = 3;
+    public static final int STRING = 4;
+    public static final int BYTES = 5;
+    public static final int TIMESTAMP = 6;
+    public static final int BLOB = 7;
+    public static final int CLOB = 8;
+
+    private final ResultSet rs;
+    private final int[] types;
+    private final int capacity;
+    private final boolean[][] nulls;
+    private final long[][] longs;
+    private final double[][] doubles;
+    private final Object[][] objects;
+    private boolean done = false;
+    private int rowCount = 0;
+
+    //! creates the fetcher for the given result set, column fetch types, and maximum block size
+    /** the fetcher is reused for all blocks read from the result set, so the column arrays are only allocated once
+     */
+    public JdbcBlockFetcher(ResultSet rs, int[] types, int capacity) {
+        this.rs = rs;
+        this.types = types;
+        this.capacity = capacity;
+        nulls = new boolean[types.length][];
+        longs = new long[types.length][];
+        doubles = new double[types.length][];
+        objects = new Object[types.length][];
+        for (int c = 0; c < types.length; ++c) {
+            switch (types[c]) {
+                case LONG:
+                case BOOLEAN:
+                    longs[c] = new long[capacity];
+                    nulls[c] = new boolean[capacity];
+                    break;
+                case DOUBLE:
+                    doubles[c] = new double[capacity];
+                    nulls[c] = new boolean[capacity];
+                    break;
+                default:
+                    objects[c] = new Object[capacity];
+                    break;
+            }
+        }
+    }
+
+    //! reads up to \a max rows (limited by the block size) and returns the number of rows read
+    /** returns 0 when the result set has been exhausted; never reads more rows than requested so that the result
+        set can continue to be used row by row afterwards
+     */
+    public int fetch(int max) throws SQLException {
+        if (done) {
+            return 0;
+        }
+        if (max <= 0 || max > capacity) {
+            max = capacity;
+        }
+        int row = 0;
+        while (row < max) {
+            if (!rs.next()) {
+                done = true;
+                break;
+            }
+            for (int c = 0; c < types.length; ++c) {
+                int col = c + 1;
+                switch (types[c]) {
+                    case LONG:
+                        longs[c][row] = rs.getLong(col);
+                        nulls[c][row] = rs.wasNull();
+                        break;
+                    case BOOLEAN:
+                        longs[c][row] = rs.getBoolean(col) ? 1 : 0;
+                        nulls[c][row] = rs.wasNull();
+                        break;
+                    case DOUBLE:
+                        doubles[c][row] = rs.getDouble(col);
+                        nulls[c][row] = rs.wasNull();
+                        break;
+                    case STRING:
+                        objects[c][row] = rs.getString(col);
+                        break;
+                    case BYTES:
+                        objects[c][row] = rs.getBytes(col);
+                        break;
+                    case TIMESTAMP: {
+                        Timestamp ts = rs.getTimestamp(col);
+                        objects[c][row] = ts == null ? null : ts.toString();
+                        break;
+                    }
+                    case BLOB:
+                    case CLOB:
+                        objects[c][row] = JdbcLobStream.get(rs, col, types[c] == CLOB,
+                            JdbcLobStream.DEFAULT_CHUNK_SIZE);
+                        break;
+                    default:
+                        objects[c][row] = rs.getObject(col);
+                        break;
+                }
+            }
+            ++row;
+        }
+        // release references to values from the previous block past the end of this block; values may be null
+        for (int c = 0; c < types.length; ++c) {
+            if (objects[c] != null) {
+                for (int i = row; i < rowCount; ++i) {
+                    objects[c][i] = null;
+                }
+            }
+        }
+        rowCount = row;
+        return row;
+    }
+
+    //! returns the number of rows read by the last call to fetch()
+    public int getRowCount() {
+        return rowCount;
+    }
+
+    //! returns the java.sql.Types value of each column of the given result set
+    /** allows cached column descriptions to be validated with a single call
+     */
+    public static int[] getColumnTypes(ResultSet rs) throws SQLException {
+        ResultSetMetaData md = rs.getMetaData();
+        int[] rv = new int[md.getColumnCount()];
+        for (int i = 0; i < rv.length; ++i) {
+            rv[i] = md.getColumnType(i + 1);
+        }
+        return rv;
+    }
+
+    //! returns the null mask for the given integer, boolean, or floating-point column (0-based)
+    public boolean[] getNulls(int c) {
+        return nulls[c];
+    }
+
+    //! returns the values for the given integer or boolean column (0-based)
+    public long[] getLongs(int c) {
+        return longs[c];
+    }
+
+    //! returns the values for the given floating-point column (0-based)
+    public double[] getDoubles(int c) {
+        return doubles[c];
+    }
+
+    //! returns the values for the given object column (0-based)
+    public Object[] getObjects(int c) {
+        return objects[c];
+    }
+}
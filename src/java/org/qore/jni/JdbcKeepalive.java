@@ -0,0 +1,110 @@
+/*
+    JdbcKeepalive.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.sql.Connection;
+import java.util.concurrent.ScheduledFuture;
+import java.util.concurrent.ScheduledThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+
+//! Validates idle JDBC connections in the background
+/** Used by the jdbc DBI driver for the \c keepalive-interval option: connections that have not been used for the
+    given interval are validated with \c Connection.isValid() in a shared daemon thread, which keeps them open and
+    allows a lost connection to be detected before the next statement is executed.
+
+    Connections are never validated while they are marked as busy.
+
+    @since 2.4
+ */
+class JdbcKeepalive implements Runnable {
+    // validation timeout in seconds
+    private static final int TIMEOUT = 1;
+
+    // shared by all connections; validation is quick and only happens for idle connections
+    private static final ScheduledThreadPoolExecutor executor = createExecutor();
+
+    private final Connection conn;
+    // native pointer to the flag set when the connection is found to be invalid
+    private final long invalidPtr;
+    private final long intervalNanos;
+    private final ScheduledFuture<?> future;
+    private boolean busy = false;
+    private long lastUsed = System.nanoTime();
+    private boolean valid = true;
+
+    //! creates the object and schedules validation for the given connection
+    /** @param conn the connection to validate
+        @param intervalMs the idle time in milliseconds after which the connection is validated
+        @param invalidPtr native pointer to the flag set when the connection is found to be invalid; must remain
+        valid until close() returns
+     */
+    public JdbcKeepalive(Connection conn, int intervalMs, long invalidPtr) {
+        this.conn = conn;
+        this.invalidPtr = invalidPtr;
+        intervalNanos = TimeUnit.MILLISECONDS.toNanos(intervalMs);
+        future = executor.scheduleWithFixedDelay(this, intervalMs, intervalMs, TimeUnit.MILLISECONDS);
+    }
+
+    //! marks the connection as busy or idle; waits for any validation in progress to complete
+    public synchronized void setBusy(boolean busy) {
+        this.busy = busy;
+        lastUsed = System.nanoTime();
+    }
+
+    //! validates the connection if it is idle
+    public synchronized void run() {
+        if (busy || !valid || (System.nanoTime() - lastUsed) < intervalNanos) {
+            return;
+        }
+        try {
+            valid = conn.isValid(TIMEOUT);
+        } catch (Throwable e) {
+            valid = false;
+        }
+        if (!valid) {
+            // the flag is read by the connection's thread before every statement execution without a Java call
+            setInvalid0(invalidPtr);
+        }
+        lastUsed = System.nanoTime();
+    }
+
+    //! stops validating the connection; waits for any validation in progress to complete
+    public void close() {
+        future.cancel(false);
+        synchronized (this) {
+            busy = true;
+        }
+    }
+
+    private native static void setInvalid0(long ptr);
+
+    private static ScheduledThreadPoolExecutor createExecutor() {
+        ScheduledThreadPoolExecutor rv = new ScheduledThreadPoolExecutor(1, r -> {
+            Thread t = new Thread(r, "qore-jdbc-keepalive");
+            t.setDaemon(true);
+            return t;
+        });
+        rv.setRemoveOnCancelPolicy(true);
+        return rv;
+    }
+}
@@ -0,0 +1,261 @@
+/*
+    JdbcLobStream.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.Reader;
+import java.nio.ByteBuffer;
+import java.nio.CharBuffer;
+import java.nio.charset.CharsetEncoder;
+import java.nio.charset.CoderResult;
+import java.nio.charset.StandardCharsets;
+import java.sql.Blob;
+import java.sql.Clob;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.util.Arrays;
+
+//! Streams the value of a BLOB or CLOB column
+/** Returned by the jdbc DBI driver for BLOB, CLOB, and NCLOB columns when the \c lob-streams option is set, so that
+    large values can be processed in chunks instead of being read into memory as a whole.
+
+    BLOB values are read with \c Blob.getBinaryStream(), CLOB values with \c Clob.getCharacterStream(); when read as
+    an \c InputStream, CLOB values are returned as UTF-8 bytes.
+
+    From %Qore, use readBinary() for BLOBs and readString() for CLOBs, which return up to one chunk of data at a
+    time and \c NOTHING when the value has been read completely.
+
+    @note the value can only be read while the LOB is valid; depending on the driver, this is until the end of the
+    transaction or until the result set is closed or moves past the row
+
+    @since 2.4
+ */
+public class JdbcLobStream extends InputStream {
+    //! the default chunk size in bytes or characters
+    public static final int DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    private final Blob blob;
+    private final Clob clob;
+    private final int chunkSize;
+    private InputStream in;
+    private Reader reader;
+
+    // UTF-8 encoding state when CLOB values are read as bytes
+    private CharsetEncoder encoder;
+    private CharBuffer chars;
+    private ByteBuffer bytes;
+    private boolean eof = false;
+
+    private JdbcLobStream(Blob blob, Clob clob, int chunkSize) {
+        this.blob = blob;
+        this.clob = clob;
+        this.chunkSize = chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE;
+    }
+
+    //! returns a stream for the given BLOB, CLOB, or NCLOB column of the current row or null if the value is NULL
+    /** @param rs the result set
+        @param col the column number, starting from 1
+        @param character true for CLOB and NCLOB columns, false for BLOB columns
+        @param chunkSize the maximum number of bytes or characters returned by a single read
+     */
+    public static JdbcLobStream get(ResultSet rs, int col, boolean character, int chunkSize) throws SQLException {
+        if (character) {
+            Clob c = rs.getClob(col);
+            return c == null ? null : new JdbcLobStream(null, c, chunkSize);
+        }
+        Blob b = rs.getBlob(col);
+        return b == null ? null : new JdbcLobStream(b, null, chunkSize);
+    }
+
+    //! returns true if the value is a CLOB or NCLOB
+    public boolean isCharacterData() {
+        return clob != null;
+    }
+
+    //! returns the length of the value in bytes (BLOB) or characters (CLOB)
+    public long length() throws SQLException {
+        return clob != null ? clob.length() : blob.length();
+    }
+
+    //! returns the maximum number of bytes or characters returned by a single read
+    public int getChunkSize() {
+        return chunkSize;
+    }
+
+    //! returns the next chunk of data or null if the value has been read completely
+    public byte[] readBinary() throws IOException {
+        return readBinary(chunkSize);
+    }
+
+    //! returns up to \a max bytes or null if the value has been read completely
+    /** fills the chunk completely unless the end of the value is reached
+     */
+    public byte[] readBinary(int max) throws IOException {
+        if (max <= 0) {
+            max = chunkSize;
+        }
+        byte[] buf = new byte[max];
+        int len = 0;
+        while (len < max) {
+            int rc = read(buf, len, max - len);
+            if (rc < 0) {
+                break;
+            }
+            len += rc;
+        }
+        if (len == 0) {
+            return null;
+        }
+        return len == max ? buf : Arrays.copyOf(buf, len);
+    }
+
+    //! returns the next chunk of characters or null if the value has been read completely
+    public String readString() throws IOException {
+        return readString(chunkSize);
+    }
+
+    //! returns up to \a max characters or null if the value has been read completely
+    /** @throws IOException if the value is not a CLOB or NCLOB or if it has been read as bytes
+     */
+    public String readString(int max) throws IOException {
+        if (clob == null) {
+            throw new IOException("cannot read a BLOB value as a string");
+        }
+        if (encoder != null) {
+            throw new IOException("cannot read a CLOB value as a string after reading it as bytes");
+        }
+        if (max <= 0) {
+            max = chunkSize;
+        }
+        Reader r = getReader();
+        char[] buf = new char[max];
+        int len = 0;
+        while (len < max) {
+            int rc = r.read(buf, len, max - len);
+            if (rc < 0) {
+                break;
+            }
+            len += rc;
+        }
+        return len == 0 ? null : new String(buf, 0, len);
+    }
+
+    @Override
+    public int read() throws IOException {
+        byte[] b = new byte[1];
+        int rc = read(b, 0, 1);
+        return rc < 0 ? -1 : (b[0] & 0xff);
+    }
+
+    @Override
+    public int read(byte[] b, int off, int len) throws IOException {
+        if (len == 0) {
+            return 0;
+        }
+        if (blob != null) {
+            return getInputStream().read(b, off, len);
+        }
+        return readEncoded(b, off, len);
+    }
+
+    //! closes the stream and frees the LOB
+    @Override
+    public void close() throws IOException {
+        try {
+            if (in != null) {
+                in.close();
+            }
+            if (reader != null) {
+                reader.close();
+            }
+            if (blob != null) {
+                blob.free();
+            } else {
+                clob.free();
+            }
+        } catch (SQLException e) {
+            throw new IOException(e);
+        } catch (AbstractMethodError | UnsupportedOperationException e) {
+            // free() is not supported by all drivers
+        }
+    }
+
+    private InputStream getInputStream() throws IOException {
+        if (in == null) {
+            try {
+                in = blob.getBinaryStream();
+            } catch (SQLException e) {
+                throw new IOException(e);
+            }
+        }
+        return in;
+    }
+
+    private Reader getReader() throws IOException {
+        if (reader == null) {
+            try {
+                reader = clob.getCharacterStream();
+            } catch (SQLException e) {
+                throw new IOException(e);
+            }
+        }
+        return reader;
+    }
+
+    // returns CLOB characters as UTF-8 bytes
+    private int readEncoded(byte[] b, int off, int len) throws IOException {
+        if (encoder == null) {
+            encoder = StandardCharsets.UTF_8.newEncoder();
+            chars = CharBuffer.allocate(Math.min(chunkSize, 64 * 1024));
+            chars.flip();
+            bytes = ByteBuffer.allocate((int)(chars.capacity() * encoder.maxBytesPerChar()));
+            bytes.flip();
+        }
+        while (!bytes.hasRemaining()) {
+            if (eof && !chars.hasRemaining()) {
+                return -1;
+            }
+            if (!eof) {
+                chars.compact();
+                int rc = getReader().read(chars);
+                if (rc < 0) {
+                    eof = true;
+                }
+                chars.flip();
+            }
+            bytes.clear();
+            CoderResult cr = encoder.encode(chars, bytes, eof);
+            if (cr.isError()) {
+                cr.throwException();
+            }
+            if (eof && !chars.hasRemaining()) {
+                encoder.flush(bytes);
+            }
+            bytes.flip();
+        }
+        int rv = Math.min(len, bytes.remaining());
+        bytes.get(b, off, rv);
+        return rv;
+    }
+}
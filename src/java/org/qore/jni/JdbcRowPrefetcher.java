@@ -0,0 +1,187 @@
+/*
+    JdbcRowPrefetcher.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.util.ArrayDeque;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.TimeUnit;
+
+//! Reads blocks of rows from a JDBC result set in a background thread
+/** Used by the jdbc DBI driver to stream result sets for \c SQLStatement fetches: blocks of rows are read with
+    JdbcBlockFetcher in a dedicated daemon thread and handed over through a bounded queue, so that database I/O
+    overlaps with the processing of the previous blocks while the memory used is limited to the queue size.
+
+    The result set must not be used by any other thread until close() has returned.  Because JDBC connections are
+    not safe for concurrent use, the background thread is stopped with stop() before the connection is used for
+    anything else; it is restarted by take() when the blocks read so far have been consumed.  All methods except
+    run() must be called by the thread that owns the connection.
+
+    @since 2.4
+ */
+class JdbcRowPrefetcher implements Runnable {
+    // marks the end of the result set in the queue
+    private static final Object END = new Object();
+
+    private final ResultSet rs;
+    private final int[] types;
+    private final int blockSize;
+    private final ArrayBlockingQueue<Object> queue;
+    // blocks read before the background thread was stopped, in order
+    private final ArrayDeque<Object> stash = new ArrayDeque<Object>();
+    // the background thread; null while stopped
+    private Thread thread;
+    private volatile boolean closed = false;
+    // an item that could not be queued because the background thread was stopped
+    private Object pending;
+    private boolean done = false;
+
+    //! creates the prefetcher and starts the background thread
+    /** @param rs the result set; it is only used by the background thread until close() is called
+        @param types the fetch type for each column as used by JdbcBlockFetcher
+        @param blockSize the maximum number of rows in a block
+        @param queueSize the maximum number of blocks that are read in advance
+     */
+    public JdbcRowPrefetcher(ResultSet rs, int[] types, int blockSize, int queueSize) {
+        this.rs = rs;
+        this.types = types;
+        this.blockSize = blockSize;
+        queue = new ArrayBlockingQueue<Object>(queueSize);
+        start();
+    }
+
+    //! reads blocks until the result set is exhausted, an error occurs, or the prefetcher is stopped or closed
+    public void run() {
+        Object item = null;
+        try {
+            while (!closed) {
+                JdbcBlockFetcher block = new JdbcBlockFetcher(rs, types, blockSize);
+                int rows = block.fetch(blockSize);
+                if (rows > 0 && !put(block)) {
+                    return;
+                }
+                if (rows < blockSize) {
+                    item = END;
+                    break;
+                }
+            }
+        } catch (Throwable e) {
+            item = e;
+        }
+        if (item != null) {
+            put(item);
+        }
+    }
+
+    //! returns the next block or null if the result set has been exhausted
+    /** rethrows any exception raised while reading the result set
+     */
+    public JdbcBlockFetcher take() throws SQLException, InterruptedException {
+        if (done) {
+            return null;
+        }
+        Object item = stash.poll();
+        if (item == null) {
+            if (thread == null) {
+                // the result set has not been exhausted; continue reading after stop()
+                start();
+            }
+            item = queue.take();
+        }
+        if (item instanceof JdbcBlockFetcher) {
+            return (JdbcBlockFetcher)item;
+        }
+        done = true;
+        if (item == END) {
+            return null;
+        }
+        if (item instanceof SQLException) {
+            throw (SQLException)item;
+        }
+        if (item instanceof RuntimeException) {
+            throw (RuntimeException)item;
+        }
+        if (item instanceof Error) {
+            throw (Error)item;
+        }
+        throw new SQLException((Throwable)item);
+    }
+
+    //! stops the background thread and waits for it to terminate without discarding the blocks already read
+    /** the connection can be used by the calling thread afterwards; reading continues when take() needs more rows
+     */
+    public void stop() throws InterruptedException {
+        if (thread == null) {
+            return;
+        }
+        closed = true;
+        // free any space in the queue so that a blocked producer returns immediately
+        queue.drainTo(stash);
+        thread.join();
+        thread = null;
+        queue.drainTo(stash);
+        if (pending != null) {
+            stash.add(pending);
+            pending = null;
+        }
+    }
+
+    //! stops the background thread and waits for it to terminate; the result set can be closed afterwards
+    public void close() throws InterruptedException {
+        closed = true;
+        // free any space in the queue so that a blocked producer notices that the prefetcher has been closed
+        queue.clear();
+        if (thread != null) {
+            thread.join();
+            thread = null;
+        }
+        queue.clear();
+        stash.clear();
+        pending = null;
+    }
+
+    // starts the background thread
+    private void start() {
+        closed = false;
+        thread = new Thread(this, "qore-jdbc-prefetch");
+        thread.setDaemon(true);
+        thread.start();
+    }
+
+    // queues the given item; returns false if the prefetcher has been stopped or closed, in which case the item is
+    // kept for stop()
+    private boolean put(Object item) {
+        try {
+            while (!closed) {
+                if (queue.offer(item, 100, TimeUnit.MILLISECONDS)) {
+                    return true;
+                }
+            }
+        } catch (InterruptedException e) {
+            // the thread has been interrupted; stop reading
+        }
+        pending = item;
+        return false;
+    }
+}
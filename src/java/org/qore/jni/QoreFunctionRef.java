@@ -0,0 +1,86 @@
+/** Java wrapper for a resolved %Qore function
+ *
+ */
+package org.qore.jni;
+
+import org.qore.jni.QoreURLClassLoader;
+
+//! A %Qore function that has been resolved once and can be called repeatedly without name lookups
+/** QoreJavaApi.callFunction() converts the function name from Java and looks up the function in %Qore on every call;
+    a %QoreFunctionRef resolves the function once when it is created, so each call only has to convert the arguments
+    and the return value.
+
+    @par Example
+    @code{.java}
+QoreFunctionRef ref = QoreFunctionRef.resolve("process_record");
+for (Object rec : records) {
+    ref.call(rec);
+}
+    @endcode
+
+    @note a %QoreFunctionRef holds a pointer to the resolved function, which is valid as long as the %Qore program
+    used to resolve it is valid; it must not be used after the program has been deleted
+
+    @since jni 2.4
+*/
+public class QoreFunctionRef {
+    //! a pointer to the Qore program used to resolve the function
+    private final long pgm;
+    //! a pointer to the resolved Qore function
+    private final long func;
+    //! the function name
+    private final String name;
+
+    private QoreFunctionRef(long pgm, long func, String name) {
+        this.pgm = pgm;
+        this.func = func;
+        this.name = name;
+    }
+
+    //! resolves the given function in the current %Qore program
+    /**
+     * @param name the name of the function; can have a namespace-justified path (ex: \c "Namespace::function")
+     * @return the resolved function
+     * @throws Throwable \c UNKNOWN-FUNCTION if the function cannot be found
+     */
+    public static QoreFunctionRef resolve(String name) throws Throwable {
+        long pgm = QoreURLClassLoader.getProgramPtr();
+        return new QoreFunctionRef(pgm, resolveFunction0(pgm, name), name);
+    }
+
+    //! returns the name of the function
+    public String getName() {
+        return name;
+    }
+
+    //! calls the function with the given arguments and returns the result
+    /**
+     * @param args arguments to the function call
+     * @return the result of the call
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see callSave()
+     */
+    public Object call(Object... args) throws Throwable {
+        return call0(pgm, func, args);
+    }
+
+    //! Calls the function with the given arguments and returns the result; if an object is returned, then a strong reference to the object is stored in thread-local data
+    /**
+     * This method can be used to save objects in thread-local data that would otherwise go out of scope; see
+     * @ref jni_qore_object_lifecycle_management for more information
+     *
+     * @param args arguments to the function call
+     * @return the result of the call
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see jni_qore_object_lifecycle_management
+     */
+    public Object callSave(Object... args) throws Throwable {
+        return callSave0(pgm, func, args);
+    }
+
+    private native static long resolveFunction0(long pgm_ptr, String name) throws Throwable;
+    private native static Object call0(long pgm_ptr, long func_ptr, Object... args);
+    private native static Object callSave0(long pgm_ptr, long func_ptr, Object... args);
+}
@@ -0,0 +1,59 @@
+/*
+    QoreFutureListener.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.util.concurrent.CompletionException;
+import java.util.concurrent.CompletionStage;
+import java.util.function.BiConsumer;
+
+//! Delivers the result of a \c CompletionStage to a %Qore \c JavaFuture object
+/** The listener is called in the thread that completes the stage, so no thread has to wait for the result.
+
+    @since 2.4
+ */
+class QoreFutureListener implements BiConsumer<Object, Throwable> {
+    //! a pointer to the %Qore JavaFuture object
+    private final long ptr;
+
+    private QoreFutureListener(long ptr) {
+        this.ptr = ptr;
+    }
+
+    //! registers a listener for the given stage
+    /** if the stage has already completed, the listener is called immediately in the current thread
+     */
+    public static void listen(CompletionStage<?> stage, long ptr) {
+        stage.whenComplete(new QoreFutureListener(ptr));
+    }
+
+    @Override
+    public void accept(Object result, Throwable error) {
+        // stages that depend on a failed stage complete with a CompletionException wrapping the original exception
+        if (error instanceof CompletionException && error.getCause() != null) {
+            error = error.getCause();
+        }
+        complete0(ptr, result, error);
+    }
+
+    private native static void complete0(long ptr, Object result, Throwable error);
+}
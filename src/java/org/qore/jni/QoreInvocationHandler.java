@@ -2,11 +2,19 @@ package org.qore.jni;
 
 import java.lang.reflect.InvocationHandler;
 import java.lang.reflect.Method;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.RejectedExecutionException;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicLong;
+import java.util.concurrent.locks.LockSupport;
 
 public class QoreInvocationHandler implements InvocationHandler {
 
     private long ptr;
     private int counter;
+    //! the asynchronous dispatch pool; null if all calls are dispatched synchronously
+    private QoreAsyncPool pool;
 
     QoreInvocationHandler(long ptr) {
         this.ptr = ptr;
@@ -17,6 +25,10 @@ public class QoreInvocationHandler implements InvocationHandler {
     public Object invoke(Object proxy, Method method, Object[] args) throws Throwable {
         long p = ref();
         try {
+            // only calls to methods without a return value can be dispatched asynchronously
+            if (pool != null && method.getReturnType() == void.class && pool.enqueue(proxy, method, args)) {
+                return null;
+            }
             return invoke0(p, proxy, method, args);
         } finally {
             deref();
@@ -26,9 +38,30 @@ public class QoreInvocationHandler implements InvocationHandler {
     @SuppressWarnings("deprecation")
     @Override
     protected void finalize() throws Throwable {
+        if (pool != null) {
+            // the worker threads free the dispatcher after dispatching all queued calls
+            long p = ptr;
+            counter = 0;
+            ptr = 0;
+            pool.shutdown(p);
+            return;
+        }
         cleanup();
     }
 
+    //! starts asynchronous dispatching of calls to methods without a return value
+    /** @param threads the number of worker threads
+        @param queueSize the maximum number of queued calls
+        @param batchSize the maximum number of calls dispatched by a worker thread with a single call to Qore
+        @param ordered if true, calls made through the same proxy object are dispatched in order by the same worker
+        thread
+        @param block if true, callers block when the queue is full, otherwise a \c RejectedExecutionException is
+        thrown
+     */
+    private void startAsync(int threads, int queueSize, int batchSize, boolean ordered, boolean block) {
+        pool = new QoreAsyncPool(ptr, threads, queueSize, batchSize, ordered, block);
+    }
+
     private synchronized long ref() {
         if (counter == 0) {
             throw new IllegalStateException("Invocation handler has already been destroyed");
@@ -44,12 +77,26 @@ public class QoreInvocationHandler implements InvocationHandler {
         }
     }
 
-    private synchronized void destroy() {
+    private void destroy() {
+        if (pool != null) {
+            // stop accepting calls and wait for the worker threads to dispatch all queued calls
+            pool.checkThread();
+            pool.shutdown(0);
+            pool.awaitTermination();
+        }
+        destroyIntern();
+    }
+
+    private synchronized void destroyIntern() {
         while (true) {
             if (counter == 0) {
                 return;
             }
             if (counter == 1) {
+                if (pool != null) {
+                    // dispatch any calls queued after the worker threads terminated
+                    pool.drain(this);
+                }
                 cleanup();
                 return;
             }
@@ -68,6 +115,224 @@ public class QoreInvocationHandler implements InvocationHandler {
         finalize0(p);
     }
 
-    private native static void finalize0(long ptr);
-    private native Object invoke0(long ptr, Object proxy, Method method, Object[] args) throws Throwable;
+    native static void finalize0(long ptr);
+    native Object invoke0(long ptr, Object proxy, Method method, Object[] args) throws Throwable;
+    native static void invokeBatch0(long ptr, Object[] proxies, Method[] methods, Object[][] args,
+        Throwable[] errors, int count);
+    native static void attach0();
+}
+
+//! a queued call
+class QoreAsyncCall {
+    final Object proxy;
+    final Method method;
+    final Object[] args;
+
+    QoreAsyncCall(Object proxy, Method method, Object[] args) {
+        this.proxy = proxy;
+        this.method = method;
+        this.args = args;
+    }
+}
+
+//! the worker threads and queues for asynchronous dispatching
+/** Each worker thread has its own lock-free queue, which any number of threads can add calls to; as only the
+    worker thread takes calls from the queue, calls in the same queue are dispatched in order.
+
+    Does not reference the handler so that the handler can be finalized while the worker threads are running.
+ */
+class QoreAsyncPool {
+    final long ptr;
+    private final QoreAsyncWorker[] workers;
+    final Semaphore slots;
+    private final int queueSize;
+    private final boolean ordered;
+    private final boolean block;
+    private final AtomicInteger next = new AtomicInteger();
+    private final AtomicInteger running;
+    volatile boolean closed = false;
+    //! if non-zero, the dispatcher to free when the last worker thread terminates
+    private final AtomicLong freePtr = new AtomicLong();
+
+    QoreAsyncPool(long ptr, int threads, int queueSize, int batchSize, boolean ordered, boolean block) {
+        this.ptr = ptr;
+        this.queueSize = queueSize;
+        this.ordered = ordered;
+        this.block = block;
+        slots = new Semaphore(queueSize);
+        running = new AtomicInteger(threads);
+        workers = new QoreAsyncWorker[threads];
+        for (int i = 0; i < threads; ++i) {
+            workers[i] = new QoreAsyncWorker(this, batchSize);
+            workers[i].thread.start();
+        }
+    }
+
+    //! queues the call; returns false if the pool has been shut down
+    boolean enqueue(Object proxy, Method method, Object[] args) throws InterruptedException {
+        if (closed) {
+            return false;
+        }
+        if (block) {
+            slots.acquire();
+        } else if (!slots.tryAcquire()) {
+            throw new RejectedExecutionException(String.format("cannot queue call to %s(); the queue is full "
+                + "with %d pending calls", method.getName(), queueSize));
+        }
+        int i = ordered ? System.identityHashCode(proxy) : next.getAndIncrement();
+        workers[(i & 0x7fffffff) % workers.length].add(new QoreAsyncCall(proxy, method, args));
+        return true;
+    }
+
+    //! stops accepting calls; the worker threads terminate when their queues are empty
+    void shutdown(long free_ptr) {
+        freePtr.set(free_ptr);
+        closed = true;
+        for (QoreAsyncWorker w : workers) {
+            LockSupport.unpark(w.thread);
+        }
+        if (running.get() == 0) {
+            freeDispatcher();
+        }
+    }
+
+    //! throws an exception if called in a worker thread, which cannot wait for itself to terminate
+    void checkThread() {
+        for (QoreAsyncWorker w : workers) {
+            if (w.thread == Thread.currentThread()) {
+                throw new IllegalStateException("cannot destroy an invocation handler from a callback that it "
+                    + "dispatched asynchronously");
+            }
+        }
+    }
+
+    void awaitTermination() {
+        for (QoreAsyncWorker w : workers) {
+            while (true) {
+                try {
+                    w.thread.join();
+                    break;
+                } catch (InterruptedException e) {
+                    // ignored
+                }
+            }
+        }
+    }
+
+    //! dispatches any remaining calls synchronously in the current thread
+    void drain(QoreInvocationHandler handler) {
+        for (QoreAsyncWorker w : workers) {
+            QoreAsyncCall c;
+            while ((c = w.queue.poll()) != null) {
+                slots.release();
+                try {
+                    handler.invoke0(ptr, c.proxy, c.method, c.args);
+                } catch (Throwable e) {
+                    report(e);
+                }
+            }
+        }
+    }
+
+    void workerDone() {
+        if (running.decrementAndGet() == 0) {
+            freeDispatcher();
+        }
+    }
+
+    private void freeDispatcher() {
+        long p = freePtr.getAndSet(0);
+        if (p != 0) {
+            QoreInvocationHandler.finalize0(p);
+        }
+    }
+
+    static void report(Throwable e) {
+        Thread t = Thread.currentThread();
+        t.getUncaughtExceptionHandler().uncaughtException(t, e);
+    }
+}
+
+//! a worker thread that dispatches calls from its queue in batches
+class QoreAsyncWorker implements Runnable {
+    private static final AtomicInteger threadCount = new AtomicInteger();
+
+    final QoreAsyncPool pool;
+    final ConcurrentLinkedQueue<QoreAsyncCall> queue = new ConcurrentLinkedQueue<QoreAsyncCall>();
+    final Thread thread;
+    private final Object[] proxies;
+    private final Method[] methods;
+    private final Object[][] args;
+    private final Throwable[] errors;
+    private volatile boolean waiting = false;
+
+    QoreAsyncWorker(QoreAsyncPool pool, int batchSize) {
+        this.pool = pool;
+        proxies = new Object[batchSize];
+        methods = new Method[batchSize];
+        args = new Object[batchSize][];
+        errors = new Throwable[batchSize];
+        thread = new Thread(this, "QoreInvocationHandler-async-" + threadCount.incrementAndGet());
+        thread.setDaemon(true);
+    }
+
+    void add(QoreAsyncCall c) {
+        queue.offer(c);
+        if (waiting) {
+            LockSupport.unpark(thread);
+        }
+    }
+
+    @Override
+    public void run() {
+        try {
+            // attach the thread to Qore once for all calls it dispatches; if this fails, each call reports the
+            // error
+            try {
+                QoreInvocationHandler.attach0();
+            } catch (Throwable e) {
+                QoreAsyncPool.report(e);
+            }
+            while (true) {
+                int n = 0;
+                QoreAsyncCall c;
+                while (n < proxies.length && (c = queue.poll()) != null) {
+                    proxies[n] = c.proxy;
+                    methods[n] = c.method;
+                    args[n] = c.args;
+                    ++n;
+                }
+                if (n == 0) {
+                    if (pool.closed) {
+                        break;
+                    }
+                    waiting = true;
+                    if (queue.isEmpty() && !pool.closed) {
+                        LockSupport.park(this);
+                    }
+                    waiting = false;
+                    continue;
+                }
+                try {
+                    QoreInvocationHandler.invokeBatch0(pool.ptr, proxies, methods, args, errors, n);
+                } catch (Throwable e) {
+                    QoreAsyncPool.report(e);
+                }
+                pool.slots.release(n);
+                for (int i = 0; i < n; ++i) {
+                    proxies[i] = null;
+                    methods[i] = null;
+                    args[i] = null;
+                    if (errors[i] != null) {
+                        QoreAsyncPool.report(errors[i]);
+                        errors[i] = null;
+                    }
+                }
+            }
+        } catch (Throwable e) {
+            QoreAsyncPool.report(e);
+        } finally {
+            pool.workerDone();
+        }
+    }
 }
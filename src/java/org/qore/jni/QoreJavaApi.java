@@ -2,12 +2,35 @@ package org.qore.jni;
 
 import org.qore.jni.QoreURLClassLoader;
 
+import java.lang.reflect.Method;
+import java.lang.reflect.Modifier;
 import java.util.Arrays;
+import java.util.List;
+import java.util.stream.Collectors;
+import java.util.stream.Stream;
 
 //! This class provides methods that allow Java to interface with Qore code
 /**
  */
 public class QoreJavaApi {
+    //! walks the stack lazily for Java stack information in %Qore call stacks
+    private static final StackWalker stackWalker = StackWalker.getInstance();
+    //! the maximum number of Java frames in %Qore call stacks; -1 = unlimited, 0 = none
+    private static volatile int stackTraceDepth = -1;
+    //! class name prefixes of Java frames to exclude from %Qore call stacks; null = no filter
+    private static volatile String[] stackTraceFilter = null;
+    //! the maximum number of frames of Java exceptions converted to %Qore exceptions; -1 = unlimited
+    private static volatile int exceptionStackDepth = -1;
+    //! the maximum number of exceptions in a cause chain included in exception descriptions
+    private static final int MaxCauses = 32;
+    //! caches the method called when a Java functional object is used as a %Qore closure for each class
+    private static final ClassValue<Method> functionalMethods = new ClassValue<Method>() {
+        @Override
+        protected Method computeValue(Class<?> cls) {
+            return findFunctionalMethod(cls);
+        }
+    };
+
     //! Initialize the \c qore library and the \c jni module from a native Java thread
     /** This method allows \c Qore functionality or Java APIs backed by \c %Qore APIs to be used from native Java
         threads in an existing JVM process not started by \c %Qore itself.
@@ -258,12 +281,356 @@ public class QoreJavaApi {
         deregisterJavaThread0();
     }
 
+    //! Enables or disables sticky %Qore thread attachment for Java threads
+    /** When enabled, Java threads that call %Qore code stay attached to %Qore after the call returns instead of
+        being attached and detached for every call, which reduces the latency of callbacks from Java thread pools.
+        Threads attached in this way are detached automatically when they terminate.
+
+        @param enable true to enable sticky attachment, false to disable it for threads that are not yet attached
+
+        @note while a thread is attached, %Qore objects saved in thread-local data with methods such as
+        QoreObject.callMethodSave() persist until the thread terminates; see
+        @ref jni_qore_object_lifecycle_management
+
+        @see @ref jni_sticky_thread_attach
+
+        @since jni 2.4
+     */
+    public static void setStickyThreadAttach(boolean enable) {
+        setStickyThreadAttach0(enable);
+    }
+
+    //! Returns true if sticky %Qore thread attachment for Java threads is enabled
+    /**
+        @see @ref jni_sticky_thread_attach
+
+        @since jni 2.4
+     */
+    public static boolean getStickyThreadAttach() {
+        return getStickyThreadAttach0();
+    }
+
+    //! Sets the maximum number of Java frames reported in %Qore call stacks
+    /** When %Qore code called from Java raises an exception or otherwise requests a call stack, the Java frames
+        below the call are reported in the %Qore call stack; limiting the number of frames reduces the cost of
+        exceptions raised in %Qore callbacks called from deep Java stacks.
+
+        @param depth the maximum number of Java frames; -1 means no limit (the default), 0 disables Java stack
+        information in %Qore call stacks
+
+        @see @ref jni_java_stack_capture
+
+        @since jni 2.4
+     */
+    public static void setStackTraceDepth(int depth) {
+        stackTraceDepth = depth < 0 ? -1 : depth;
+    }
+
+    //! Returns the maximum number of Java frames reported in %Qore call stacks; -1 means no limit
+    /**
+        @see @ref jni_java_stack_capture
+
+        @since jni 2.4
+     */
+    public static int getStackTraceDepth() {
+        return stackTraceDepth;
+    }
+
+    //! Sets class name prefixes of Java frames to exclude from %Qore call stacks
+    /** @param prefixes class name prefixes (ex: \c "org.springframework."); frames of classes whose names start
+        with any of the prefixes are not reported; null and empty prefixes are ignored, so no arguments or null
+        clears the filter
+
+        @note filtered frames do not count towards the limit set with setStackTraceDepth()
+
+        @see @ref jni_java_stack_capture
+
+        @since jni 2.4
+     */
+    public static void setStackTraceFilter(String... prefixes) {
+        String[] filter = prefixes == null
+            ? null
+            : Arrays.stream(prefixes).filter(p -> p != null && !p.isEmpty()).toArray(String[]::new);
+        stackTraceFilter = filter == null || filter.length == 0 ? null : filter;
+    }
+
+    //! Returns the class name prefixes of Java frames excluded from %Qore call stacks or null if there are none
+    /**
+        @see @ref jni_java_stack_capture
+
+        @since jni 2.4
+     */
+    public static String[] getStackTraceFilter() {
+        String[] filter = stackTraceFilter;
+        return filter == null ? null : filter.clone();
+    }
+
+    //! Sets the maximum number of Java frames in the call stacks of Java exceptions converted to %Qore exceptions
+    /** Converting a Java exception to a %Qore exception converts every frame of the Java stack trace to a %Qore call
+        stack entry; limiting the number of frames bounds the cost of converting exceptions thrown from deep Java
+        stacks.  If frames are omitted, a final call stack entry gives the number of omitted frames.
+
+        @param depth the maximum number of frames; -1 means no limit (the default)
+
+        @see @ref jni_exception_conversion
+
+        @since jni 2.4
+     */
+    public static void setExceptionStackDepth(int depth) {
+        exceptionStackDepth = depth < 0 ? -1 : depth;
+    }
+
+    //! Returns the maximum number of Java frames in the call stacks of converted exceptions; -1 means no limit
+    /**
+        @see @ref jni_exception_conversion
+
+        @since jni 2.4
+     */
+    public static int getExceptionStackDepth() {
+        return exceptionStackDepth;
+    }
+
     //! Returns the current stack trace, not including the call to this method
     public static StackTraceElement[] getStackTrace() {
         StackTraceElement[] stack = new Exception().getStackTrace();
         return stack.length > 0 ? Arrays.copyOfRange(stack, 1, stack.length) : null;
     }
 
+    //! Returns frames of the current stack for %Qore call stacks, not including the call to this method
+    /** The stack is walked lazily, so only the requested frames are materialized; frames are subject to the limit
+        set with setStackTraceDepth() and the filter set with setStackTraceFilter().
+
+        @param skip the number of frames to skip, after filtering
+        @param count the maximum number of frames to return
+
+        @return null if there are no frames, otherwise an array of three elements: a \c String[] of
+        <tt>class.method</tt> names, a \c String[] of file names, and an \c int[] of line numbers, where -2 means
+        a native method
+     */
+    static Object[] getStackFrames(int skip, int count) {
+        int depth = stackTraceDepth;
+        if (depth >= 0 && skip >= depth) {
+            return null;
+        }
+        int limit = depth >= 0 ? Math.min(count, depth - skip) : count;
+        String[] filter = stackTraceFilter;
+        List<StackWalker.StackFrame> frames = stackWalker.walk(s -> {
+            Stream<StackWalker.StackFrame> fs = s.skip(1);
+            if (filter != null) {
+                fs = fs.filter(f -> !isFiltered(f.getClassName(), filter));
+            }
+            return fs.skip(skip).limit(limit).collect(Collectors.toList());
+        });
+        int len = frames.size();
+        if (len == 0) {
+            return null;
+        }
+        String[] calls = new String[len];
+        String[] files = new String[len];
+        int[] lines = new int[len];
+        for (int i = 0; i < len; ++i) {
+            StackWalker.StackFrame f = frames.get(i);
+            calls[i] = f.getClassName() + "." + f.getMethodName();
+            files[i] = f.getFileName();
+            lines[i] = f.getLineNumber();
+        }
+        return new Object[]{calls, files, lines};
+    }
+
+    //! Returns the description of the given throwable and its causes
+    /** @param t the throwable
+        @param chain if true, the causes are included in the description
+
+        @return <tt>class: message</tt> for the throwable and, if \c chain is true, each cause, separated by
+        <tt>": "</tt>
+     */
+    static String getThrowableDescription(Throwable t, boolean chain) {
+        StringBuilder desc = new StringBuilder();
+        for (int i = 0; t != null && i < MaxCauses; ++i) {
+            if (i > 0) {
+                desc.append(": ");
+            }
+            desc.append(t.getClass().getName());
+            String msg;
+            try {
+                msg = t.getMessage();
+            } catch (Throwable e) {
+                msg = null;
+            }
+            if (msg != null) {
+                desc.append(": ").append(msg);
+            }
+            if (!chain) {
+                break;
+            }
+            Throwable cause = t.getCause();
+            t = cause == t ? null : cause;
+        }
+        return desc.toString();
+    }
+
+    //! Returns the information needed to convert the given throwable to a %Qore exception
+    /** All information is returned in one call, so that the conversion does not need several JNI calls for each
+        frame.
+
+        @param t the throwable
+
+        @return an array of four elements: the description of the throwable as returned by
+        getThrowableDescription() without causes, a \c String[] of <tt>class.method</tt> names, a \c String[] of
+        file names, and an \c int[] of line numbers, where -2 means a native method; the \c int[] has one
+        additional element at the end giving the number of frames omitted due to the limit set with
+        setExceptionStackDepth()
+     */
+    static Object[] getThrowableInfo(Throwable t) {
+        StackTraceElement[] stack = t.getStackTrace();
+        int depth = exceptionStackDepth;
+        int len = depth >= 0 && depth < stack.length ? depth : stack.length;
+        String[] calls = new String[len];
+        String[] files = new String[len];
+        int[] lines = new int[len + 1];
+        for (int i = 0; i < len; ++i) {
+            StackTraceElement e = stack[i];
+            calls[i] = e.getClassName() + "." + e.getMethodName();
+            files[i] = e.getFileName();
+            lines[i] = e.isNativeMethod() ? -2 : e.getLineNumber();
+        }
+        lines[len] = stack.length - len;
+        return new Object[]{getThrowableDescription(t, false), calls, files, lines};
+    }
+
+    //! Returns the method to call when an object of the given class is used as a %Qore closure
+    /** For classes implementing QoreClosureMarker, this is the \c call() method; otherwise it is the single
+        abstract method of a functional interface implemented by the class, such as \c Function.apply() for a
+        \c java.util.function.Function; the result is cached for each class.
+
+        Interfaces annotated with \c \@FunctionalInterface or from the \c java.util.function package are preferred;
+        other single-method interfaces are only used if they are not JDK interfaces, so that interfaces such as
+        \c AutoCloseable or \c Comparable are not treated as functional interfaces.
+
+        @param cls the class of the object
+
+        @return the method or null if the class does not implement a functional interface
+     */
+    static Method getFunctionalMethod(Class<?> cls) {
+        return functionalMethods.get(cls);
+    }
+
+    private static Method findFunctionalMethod(Class<?> cls) {
+        boolean marker = QoreClosureMarker.class.isAssignableFrom(cls);
+        // single-method interfaces that are not declared as functional interfaces (ex: AutoCloseable) are only used
+        // if no declared functional interface is implemented
+        Method fallback = null;
+        for (Class<?> c = cls; c != null; c = c.getSuperclass()) {
+            for (Class<?> i : c.getInterfaces()) {
+                Method m = findInterfaceMethod(i, marker);
+                if (m == null) {
+                    continue;
+                }
+                if (marker || isDeclaredFunctional(i)) {
+                    return m;
+                }
+                if (fallback == null && !isJdkInterface(i)) {
+                    fallback = m;
+                }
+            }
+        }
+        if (marker) {
+            // the call() method may be declared in the class itself
+            for (Class<?> c = cls; c != null; c = c.getSuperclass()) {
+                for (Method m : c.getDeclaredMethods()) {
+                    if (m.getName().equals("call")) {
+                        return m;
+                    }
+                }
+            }
+        }
+        return fallback;
+    }
+
+    private static Method findInterfaceMethod(Class<?> iface, boolean marker) {
+        Method rv = null;
+        for (Method m : iface.getMethods()) {
+            if (!Modifier.isAbstract(m.getModifiers()) || m.isBridge() || m.isSynthetic() || isObjectMethod(m)) {
+                continue;
+            }
+            if (marker) {
+                if (m.getName().equals("call")) {
+                    return m;
+                }
+                continue;
+            }
+            if (rv != null) {
+                // generic redeclarations of the same method (ex: apply(String) and apply(Object)) are
+                // override-equivalent; the most specific declaration is used for argument conversions
+                if (isMoreSpecific(m, rv)) {
+                    rv = m;
+                    continue;
+                }
+                if (isMoreSpecific(rv, m)) {
+                    continue;
+                }
+                // the interface is not a functional interface if it has more than one abstract method
+                return null;
+            }
+            rv = m;
+        }
+        return rv;
+    }
+
+    //! returns true if the first method redeclares the second with the same or narrower parameter types
+    private static boolean isMoreSpecific(Method m, Method other) {
+        if (!m.getName().equals(other.getName()) || m.getParameterCount() != other.getParameterCount()) {
+            return false;
+        }
+        Class<?>[] params = m.getParameterTypes();
+        Class<?>[] otherParams = other.getParameterTypes();
+        for (int i = 0; i < params.length; ++i) {
+            if (!otherParams[i].isAssignableFrom(params[i])) {
+                return false;
+            }
+        }
+        return other.getReturnType().isAssignableFrom(m.getReturnType());
+    }
+
+    //! returns true if the interface or one of its superinterfaces is declared as a functional interface
+    private static boolean isDeclaredFunctional(Class<?> iface) {
+        if (iface.isAnnotationPresent(FunctionalInterface.class)
+            || iface.getName().startsWith("java.util.function.")) {
+            return true;
+        }
+        for (Class<?> i : iface.getInterfaces()) {
+            if (isDeclaredFunctional(i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! returns true for JDK interfaces, which are annotated if they are intended to be used as functional interfaces
+    private static boolean isJdkInterface(Class<?> iface) {
+        String name = iface.getName();
+        return name.startsWith("java.") || name.startsWith("javax.");
+    }
+
+    //! returns true if the method is a public method of java.lang.Object, which functional interfaces may redeclare
+    private static boolean isObjectMethod(Method m) {
+        try {
+            Object.class.getMethod(m.getName(), m.getParameterTypes());
+            return true;
+        } catch (NoSuchMethodException e) {
+            return false;
+        }
+    }
+
+    private static boolean isFiltered(String className, String[] filter) {
+        for (String prefix : filter) {
+            if (className.startsWith(prefix)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     private native static long initQore0() throws Throwable;
     private native static void initQoreBootstrap0() throws Throwable;
     private native static Object callFunction0(long pgm_ptr, String name, Object... args) throws Throwable;
@@ -273,4 +640,6 @@ public class QoreJavaApi {
     private native static QoreObject newObjectSave0(long pgm_ptr, String class_name, Object...args) throws Throwable;
     private native static boolean registerJavaThread0();
     private native static void deregisterJavaThread0();
+    private native static void setStickyThreadAttach0(boolean enable);
+    private native static boolean getStickyThreadAttach0();
 }
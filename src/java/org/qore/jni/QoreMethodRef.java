@@ -0,0 +1,204 @@
+/** Java wrapper for a resolved %Qore method
+ *
+ */
+package org.qore.jni;
+
+import org.qore.jni.QoreObject;
+import org.qore.jni.QoreURLClassLoader;
+
+//! A %Qore method that has been resolved once and can be called repeatedly without name lookups
+/** QoreObject.callMethod() and QoreJavaApi.callStaticMethod() convert the method name from Java and look up the
+    method (and for static methods, also the class) in %Qore on every call; a %QoreMethodRef resolves the method once
+    when it is created, so each call only has to convert the arguments and the return value.
+
+    This is useful for Java code that calls back into %Qore many times, for example once per record.
+
+    @par Example
+    @code{.java}
+QoreMethodRef ref = QoreMethodRef.forObject(obj, "process");
+for (Object rec : records) {
+    ref.call(obj, rec);
+}
+    @endcode
+
+    Normal methods are dispatched like %Qore method calls: when the object passed to call() or callSave() belongs to
+    a subclass that overrides the resolved method, the override is called.  The override is looked up once per
+    subclass and cached in the %QoreMethodRef.
+
+    @note a %QoreMethodRef holds a pointer to the resolved method, which is valid as long as the %Qore program that
+    the class belongs to is valid; it must not be used after the program has been deleted
+
+    @since jni 2.4
+*/
+public class QoreMethodRef {
+    //! a pointer to the Qore program used to resolve the method
+    private final long pgm;
+    //! a pointer to the resolved Qore method and the overrides found for subclasses
+    private long method;
+    //! the class name
+    private final String className;
+    //! the method name
+    private final String name;
+    //! true if the method is static
+    private final boolean isStatic;
+
+    private QoreMethodRef(long pgm, long method, String className, String name, boolean isStatic) {
+        this.pgm = pgm;
+        this.method = method;
+        this.className = className;
+        this.name = name;
+        this.isStatic = isStatic;
+    }
+
+    //! resolves the given normal method in the class of the given object
+    /**
+     * @param obj the object whose class is used to resolve the method
+     * @param name the name of the method
+     * @return the resolved method, which can be called with any object of the same class or a subclass
+     * @throws Throwable \c UNKNOWN-METHOD if the method cannot be found
+     */
+    public static QoreMethodRef forObject(QoreObject obj, String name) throws Throwable {
+        long pgm = QoreURLClassLoader.getProgramPtr();
+        return new QoreMethodRef(pgm, resolveMethod0(pgm, obj.get(), null, name, false), obj.className(), name,
+            false);
+    }
+
+    //! resolves the given normal method in the given class
+    /**
+     * @param className the name of the class; can have a namespace-justified path (ex: \c "Namespace::ClassName")
+     * @param name the name of the method
+     * @return the resolved method, which can be called with any object of the class or a subclass
+     * @throws Throwable \c UNKNOWN-CLASS if the class cannot be found, \c UNKNOWN-METHOD if the method cannot be
+     * found
+     */
+    public static QoreMethodRef forClass(String className, String name) throws Throwable {
+        long pgm = QoreURLClassLoader.getProgramPtr();
+        return new QoreMethodRef(pgm, resolveMethod0(pgm, 0, className, name, false), className, name, false);
+    }
+
+    //! resolves the given static method in the given class
+    /**
+     * @param className the name of the class; can have a namespace-justified path (ex: \c "Namespace::ClassName")
+     * @param name the name of the static method
+     * @return the resolved static method
+     * @throws Throwable \c UNKNOWN-CLASS if the class cannot be found, \c UNKNOWN-METHOD if the static method cannot
+     * be found
+     */
+    public static QoreMethodRef forStatic(String className, String name) throws Throwable {
+        long pgm = QoreURLClassLoader.getProgramPtr();
+        return new QoreMethodRef(pgm, resolveMethod0(pgm, 0, className, name, true), className, name, true);
+    }
+
+    //! returns the name of the class used to resolve the method
+    public String getClassName() {
+        return className;
+    }
+
+    //! returns the name of the method
+    public String getName() {
+        return name;
+    }
+
+    //! returns true if the method is static
+    public boolean isStatic() {
+        return isStatic;
+    }
+
+    //! calls the method on the given object with the given arguments and returns the result
+    /**
+     * @param obj the object to call the method on; must be an instance of the method's class
+     * @param args arguments to the method call
+     * @return the result of the call
+     * @throws IllegalStateException if the method is static
+     * @throws IllegalArgumentException if the object is not an instance of the method's class
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see callSave()
+     */
+    public Object call(QoreObject obj, Object... args) throws Throwable {
+        checkNormal();
+        return call0(pgm, method, obj.get(), args);
+    }
+
+    //! Calls the method on the given object with the given arguments and returns the result; if an object is returned, then a strong reference to the object is stored in thread-local data
+    /**
+     * This method can be used to save objects in thread-local data that would otherwise go out of scope; see
+     * @ref jni_qore_object_lifecycle_management for more information
+     *
+     * @param obj the object to call the method on; must be an instance of the method's class
+     * @param args arguments to the method call
+     * @return the result of the call
+     * @throws IllegalStateException if the method is static
+     * @throws IllegalArgumentException if the object is not an instance of the method's class
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see jni_qore_object_lifecycle_management
+     */
+    public Object callSave(QoreObject obj, Object... args) throws Throwable {
+        checkNormal();
+        return callSave0(pgm, method, obj.get(), args);
+    }
+
+    //! calls the static method with the given arguments and returns the result
+    /**
+     * @param args arguments to the method call
+     * @return the result of the call
+     * @throws IllegalStateException if the method is not static
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see callStaticSave()
+     */
+    public Object callStatic(Object... args) throws Throwable {
+        checkStatic();
+        return callStatic0(pgm, method, args);
+    }
+
+    //! Calls the static method with the given arguments and returns the result; if an object is returned, then a strong reference to the object is stored in thread-local data
+    /**
+     * This method can be used to save objects in thread-local data that would otherwise go out of scope; see
+     * @ref jni_qore_object_lifecycle_management for more information
+     *
+     * @param args arguments to the method call
+     * @return the result of the call
+     * @throws IllegalStateException if the method is not static
+     * @throws Throwable any Qore-language exception is rethrown here
+     *
+     * @see jni_qore_object_lifecycle_management
+     */
+    public Object callStaticSave(Object... args) throws Throwable {
+        checkStatic();
+        return callStaticSave0(pgm, method, args);
+    }
+
+    //! releases the resolved method
+    @SuppressWarnings("deprecation")
+    @Override
+    protected void finalize() throws Throwable {
+        if (method != 0) {
+            finalize0(method);
+            method = 0;
+        }
+    }
+
+    private void checkNormal() {
+        if (isStatic) {
+            throw new IllegalStateException(String.format("%s::%s() is a static method; use callStatic() instead",
+                className, name));
+        }
+    }
+
+    private void checkStatic() {
+        if (!isStatic) {
+            throw new IllegalStateException(String.format("%s::%s() is not a static method; use call() instead",
+                className, name));
+        }
+    }
+
+    private native static long resolveMethod0(long pgm_ptr, long obj_ptr, String class_name, String name,
+        boolean is_static) throws Throwable;
+    private native static Object call0(long pgm_ptr, long method_ptr, long obj_ptr, Object... args);
+    private native static Object callSave0(long pgm_ptr, long method_ptr, long obj_ptr, Object... args);
+    private native static Object callStatic0(long pgm_ptr, long method_ptr, Object... args);
+    private native static Object callStaticSave0(long pgm_ptr, long method_ptr, Object... args);
+    private native static void finalize0(long method_ptr);
+}
@@ -0,0 +1,210 @@
+/*
+    QoreParallelMap.java
+
+    Qore Programming Language JNI Module
+
+    Copyright (C) 2016 - 2024 Qore Technologies, s.r.o.
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+package org.qore.jni;
+
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Spliterator;
+import java.util.Spliterators;
+import java.util.concurrent.ForkJoinPool;
+import java.util.concurrent.ForkJoinWorkerThread;
+import java.util.concurrent.RecursiveAction;
+import java.util.concurrent.atomic.AtomicReference;
+
+//! Applies a %Qore closure to the elements of a Java collection in parallel for \c jni::parallel_map()
+/** The collection is split with its \c Spliterator, and the closure is called in \c ForkJoinPool worker threads that
+    are attached to %Qore when they start and stay attached until they terminate.
+
+    Each element is passed to %Qore with its position in the collection, so the results are stored in order by the
+    native code without having to be collected in Java.
+
+    @since 2.4
+ */
+class QoreParallelMap extends RecursiveAction {
+    //! the shared pool used when no parallelism is given
+    private static volatile ForkJoinPool sharedPool;
+
+    //! creates worker threads that are attached to %Qore
+    private static final ForkJoinPool.ForkJoinWorkerThreadFactory factory =
+        (ForkJoinPool pool) -> new QoreParallelMapThread(pool);
+
+    private final QoreParallelMapJob job;
+    private final Spliterator<?> split;
+    //! the position of the first element of the spliterator in the collection
+    private final long offset;
+
+    private QoreParallelMap(QoreParallelMapJob job, Spliterator<?> split, long offset) {
+        this.job = job;
+        this.split = split;
+        this.offset = offset;
+    }
+
+    //! applies the closure to all elements of the collection
+    /** @param ptr a pointer to the native map context
+        @param c the collection
+        @param parallelism the number of worker threads; if 0, the shared pool is used
+        @param batchSize the maximum number of elements processed by a task without splitting it; if 0, a value
+        is calculated from the size of the collection and the parallelism
+
+        @return the number of elements processed; if the native code recorded a %Qore exception, it is raised by the
+        caller
+     */
+    static long map(long ptr, Object c, int parallelism, long batchSize) throws Throwable {
+        if (!(c instanceof Collection)) {
+            throw new IllegalArgumentException(String.format("expecting a java.util.Collection object; got class %s",
+                c == null ? "null" : c.getClass().getName()));
+        }
+        Collection<?> col = (Collection<?>)c;
+        Spliterator<?> split = col.spliterator();
+        // positions can only be calculated for splits with an exact size; other collections are copied to an
+        // array, which only copies the references to the elements
+        if (!split.hasCharacteristics(Spliterator.SUBSIZED)) {
+            split = Spliterators.spliterator(col.toArray(), Spliterator.ORDERED);
+        }
+        long size = split.getExactSizeIfKnown();
+        if (size == 0) {
+            start0(ptr, 0);
+            return 0;
+        }
+
+        ForkJoinPool pool = parallelism > 0 ? new ForkJoinPool(parallelism, factory, null, false) : getSharedPool();
+        try {
+            if (batchSize <= 0) {
+                // create a few tasks per thread so that threads that finish early can steal work
+                batchSize = Math.max(1, size / (pool.getParallelism() * 4L));
+            }
+            start0(ptr, size);
+            QoreParallelMapJob job = new QoreParallelMapJob(ptr, batchSize);
+            pool.invoke(new QoreParallelMap(job, split, 0));
+            Throwable e = job.error.get();
+            if (e != null) {
+                throw e;
+            }
+        } finally {
+            if (parallelism > 0) {
+                pool.shutdown();
+            }
+        }
+        return size;
+    }
+
+    //! returns the shared pool, creating it if necessary
+    private static ForkJoinPool getSharedPool() {
+        ForkJoinPool pool = sharedPool;
+        if (pool == null) {
+            synchronized (QoreParallelMap.class) {
+                pool = sharedPool;
+                if (pool == null) {
+                    pool = new ForkJoinPool(Runtime.getRuntime().availableProcessors(), factory, null, false);
+                    sharedPool = pool;
+                }
+            }
+        }
+        return pool;
+    }
+
+    @Override
+    protected void compute() {
+        Spliterator<?> s = split;
+        long pos = offset;
+        ArrayList<QoreParallelMap> forks = null;
+        try {
+            Spliterator<?> prefix;
+            while (!job.failed && s.estimateSize() > job.batchSize && (prefix = s.trySplit()) != null) {
+                QoreParallelMap t = new QoreParallelMap(job, prefix, pos);
+                pos += prefix.getExactSizeIfKnown();
+                if (forks == null) {
+                    forks = new ArrayList<QoreParallelMap>();
+                }
+                forks.add(t);
+                t.fork();
+            }
+            // process the remaining elements in this thread
+            long[] i = {pos};
+            boolean more = true;
+            while (more && !job.failed) {
+                more = s.tryAdvance(v -> {
+                    if (!apply0(job.ptr, v, i[0]++)) {
+                        job.failed = true;
+                    }
+                });
+            }
+        } catch (Throwable e) {
+            job.error.compareAndSet(null, e);
+            job.failed = true;
+        } finally {
+            // the native context must not be used after the map operation returns, so all tasks must complete
+            // before this one does
+            if (forks != null) {
+                for (QoreParallelMap t : forks) {
+                    t.quietlyJoin();
+                }
+            }
+        }
+    }
+
+    //! allocates storage for the given number of results
+    private native static void start0(long ptr, long size);
+
+    //! applies the closure to the given element and stores the result at the given position
+    /** @return false if a %Qore exception was raised, in which case the map operation is stopped
+     */
+    private native static boolean apply0(long ptr, Object value, long pos);
+}
+
+//! the state shared by all tasks of a single map operation
+class QoreParallelMapJob {
+    //! a pointer to the native map context
+    final long ptr;
+    //! the maximum number of elements processed by a task without splitting it
+    final long batchSize;
+    //! the first exception thrown by a task
+    final AtomicReference<Throwable> error = new AtomicReference<Throwable>();
+    //! set when the native code has recorded a %Qore exception or a task has thrown an exception
+    volatile boolean failed = false;
+
+    QoreParallelMapJob(long ptr, long batchSize) {
+        this.ptr = ptr;
+        this.batchSize = batchSize;
+    }
+}
+
+//! a worker thread that is attached to %Qore when it starts and stays attached until it terminates
+class QoreParallelMapThread extends ForkJoinWorkerThread {
+    QoreParallelMapThread(ForkJoinPool pool) {
+        super(pool);
+        setName("QoreParallelMap-" + getPoolIndex());
+    }
+
+    @Override
+    protected void onStart() {
+        super.onStart();
+        // attach the thread to Qore once for all elements it processes; if this fails, each call attaches the
+        // thread temporarily
+        try {
+            QoreInvocationHandler.attach0();
+        } catch (Throwable e) {
+            // ignored
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/** Java task wrapper for a %Qore closure
+ *
+ */
+package org.qore.jni;
+
+import java.util.Objects;
+import java.util.concurrent.Callable;
+import java.util.function.Supplier;
+
+import org.qore.jni.QoreClosure;
+import org.qore.jni.QoreURLClassLoader;
+
+//! Runs a %Qore closure or call reference as a Java \c Runnable, \c Callable or \c Supplier task
+/** A %QoreTask can be submitted to any Java executor, such as an \c ExecutorService, a
+    \c ScheduledExecutorService or \c CompletableFuture.supplyAsync(), without writing a proxy class.
+
+    The closure is resolved when the task is created, and the %Qore program used to call it is stored in the task,
+    so it can be called in any Java thread.  By default, a thread that runs the task is attached to %Qore on the
+    first task it runs and stays attached until it terminates, so the threads of a Java thread pool only pay the
+    cost of attaching to %Qore once; see setStickyAttach() for tasks run in thread pools of an unbounded size.
+
+    %Qore code values passed to Java methods that expect a \c Runnable, \c Callable or \c Supplier argument are
+    converted to %QoreTask objects automatically.
+
+    @par Example
+    @code{.py}
+%module-cmd(jni) import org.qore.jni.QoreTask
+%module-cmd(jni) import java.util.concurrent.Executors
+
+ExecutorService pool = Executors::newFixedThreadPool(4);
+pool.execute(new QoreTask(sub () { process(); }));
+    @endcode
+
+    @note exceptions raised by the closure are thrown as Java exceptions in the thread running the task; for
+    Runnable tasks submitted with \c Executor.execute(), they are passed to the thread's uncaught exception handler
+
+    @since jni 2.4
+*/
+public class QoreTask implements Runnable, Callable<Object>, Supplier<Object> {
+    //! a pointer to the Qore program used to call the closure
+    private final long pgm;
+    //! the closure
+    private final QoreClosure closure;
+    //! if true, threads running the task stay attached to %Qore until they terminate
+    private volatile boolean stickyAttach;
+
+    //! creates the task with the given closure, which is called in the current %Qore program
+    /** threads running the task stay attached to %Qore until they terminate
+
+        @param closure the closure or call reference to call when the task is run
+     */
+    public QoreTask(QoreClosure closure) {
+        this(QoreURLClassLoader.getProgramPtr(), closure, true);
+    }
+
+    //! creates the task with the given closure, which is called in the current %Qore program
+    /**
+     * @param closure the closure or call reference to call when the task is run
+     * @param stickyAttach if true, threads running the task stay attached to %Qore until they terminate; if false,
+     * they are attached for each call unless @ref jni_sticky_thread_attach "sticky thread attachment" is enabled
+     * globally
+     *
+     * @see setStickyAttach()
+     */
+    public QoreTask(QoreClosure closure, boolean stickyAttach) {
+        this(QoreURLClassLoader.getProgramPtr(), closure, stickyAttach);
+    }
+
+    QoreTask(long pgm, QoreClosure closure) {
+        this(pgm, closure, true);
+    }
+
+    QoreTask(long pgm, QoreClosure closure, boolean stickyAttach) {
+        this.pgm = pgm;
+        this.closure = Objects.requireNonNull(closure);
+        this.stickyAttach = stickyAttach;
+    }
+
+    //! returns the closure
+    public QoreClosure getClosure() {
+        return closure;
+    }
+
+    //! sets whether threads running the task stay attached to %Qore until they terminate
+    /** Sticky attachment is enabled by default, so the threads of a Java thread pool are only attached to %Qore
+        once.  If disabled, threads are attached to %Qore for each call and detached again when it returns, unless
+        @ref jni_sticky_thread_attach "sticky thread attachment" is enabled globally.
+
+        @param stickyAttach true to keep threads running the task attached to %Qore, false to detach them after
+        each call
+
+        @note each thread that stays attached uses a %Qore thread ID until it terminates; disable sticky attachment
+        for tasks run in thread pools of an unbounded size, such as \c Executors.newCachedThreadPool() or
+        \c ForkJoinPool.commonPool() with managed blocking, to avoid registering an unbounded number of threads with
+        %Qore
+     */
+    public void setStickyAttach(boolean stickyAttach) {
+        this.stickyAttach = stickyAttach;
+    }
+
+    //! returns true if threads running the task stay attached to %Qore until they terminate
+    /**
+     * @see setStickyAttach()
+     */
+    public boolean getStickyAttach() {
+        return stickyAttach;
+    }
+
+    //! calls the closure and ignores the result
+    /**
+     * @throws RuntimeException any Qore-language exception is rethrown here
+     */
+    @Override
+    public void run() {
+        call0(pgm, closure, stickyAttach);
+    }
+
+    //! calls the closure and returns the result
+    /**
+     * @return the result of the call
+     * @throws Exception any Qore-language exception is rethrown here
+     */
+    @Override
+    public Object call() throws Exception {
+        return call0(pgm, closure, stickyAttach);
+    }
+
+    //! calls the closure and returns the result
+    /**
+     * @return the result of the call
+     * @throws RuntimeException any Qore-language exception is rethrown here
+     */
+    @Override
+    public Object get() {
+        return call0(pgm, closure, stickyAttach);
+    }
+
+    // the closure is passed instead of its pointer so that it cannot be finalized while it is being called
+    private native static Object call0(long pgm_ptr, QoreClosure closure, boolean sticky);
+}
@@ -48,6 +48,7 @@
 #include "QoreToJava.h"
 #include "Globals.h"
 #include "QoreJdbcDriver.h"
+#include "ModifiedUtf8String.h"
 
 using namespace jni;
 
@@ -84,6 +85,8 @@ DLLEXPORT char qore_module_license_str[] = "MIT";
 
 // global type compatibility option
 DLLLOCAL bool jni_compat_types = false;
+// global lazy import option
+DLLLOCAL bool jni_lazy_import = false;
 
 static bool jni_init_failed = false;
 
@@ -98,6 +101,7 @@ static void qore_jni_mc_add_relative_classpath(const QoreString& arg, QoreProgra
 static void qore_jni_mc_define_pending_class(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
 static void qore_jni_mc_define_class(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
 static void qore_jni_mc_set_compat_types(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
+static void qore_jni_mc_set_lazy_import(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
 static void qore_jni_mc_set_property(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
 static void qore_jni_mc_mark_module_injected(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc);
 
@@ -112,6 +116,7 @@ static mcmap_t mcmap = {
     {"global-add-classpath", qore_jni_mc_global_add_classpath},
     {"global-add-relative-classpath", qore_jni_mc_global_add_relative_classpath},
     {"set-compat-types", qore_jni_mc_set_compat_types},
+    {"set-lazy-import", qore_jni_mc_set_lazy_import},
     {"set-property", qore_jni_mc_set_property},
     {"mark-module-injected", qore_jni_mc_mark_module_injected},
 };
@@ -120,6 +125,70 @@ static void jni_thread_cleanup(void*) {
     jni::Jvm::threadCleanup();
 }
 
+// sets the Java stack capture and exception conversion options from module options or environment variables
+static void jni_set_java_stack_options() {
+    ExceptionSink xsink;
+    Env env;
+
+    ValueHolder depth(qore_get_module_option("jni", "java-stack-depth"), &xsink);
+    QoreString val;
+    if (depth || !SystemEnvironment::get("QORE_JNI_JAVA_STACK_DEPTH", val)) {
+        jvalue jarg;
+        jarg.i = depth ? (jint)depth->getAsBigInt() : (jint)strtoll(val.c_str(), nullptr, 10);
+        env.callStaticVoidMethod(Globals::classQoreJavaApi, Globals::methodQoreJavaApiSetStackTraceDepth, &jarg);
+    }
+
+    ValueHolder exception_depth(qore_get_module_option("jni", "java-exception-frames"), &xsink);
+    val.clear();
+    if (exception_depth || !SystemEnvironment::get("QORE_JNI_JAVA_EXCEPTION_FRAMES", val)) {
+        jvalue jarg;
+        jarg.i = exception_depth ? (jint)exception_depth->getAsBigInt() : (jint)strtoll(val.c_str(), nullptr, 10);
+        env.callStaticVoidMethod(Globals::classQoreJavaApi, Globals::methodQoreJavaApiSetExceptionStackDepth, &jarg);
+    }
+
+    // the filter is a list of class name prefixes or a string of comma-separated prefixes
+    std::vector<std::string> prefixes;
+    ValueHolder filter(qore_get_module_option("jni", "java-stack-filter"), &xsink);
+    val.clear();
+    if (filter && filter->getType() == NT_LIST) {
+        ConstListIterator i(filter->get<const QoreListNode>());
+        while (i.next()) {
+            QoreStringValueHelper str(i.getValue(), QCS_UTF8, &xsink);
+            prefixes.push_back(str->c_str());
+        }
+    } else {
+        if (filter) {
+            QoreStringValueHelper str(*filter, QCS_UTF8, &xsink);
+            val.concat(str->c_str());
+        } else {
+            SystemEnvironment::get("QORE_JNI_JAVA_STACK_FILTER", val);
+        }
+        const char* p = val.c_str();
+        while (*p) {
+            const char* c = strchr(p, ',');
+            prefixes.push_back(c ? std::string(p, c - p) : std::string(p));
+            if (!c) {
+                break;
+            }
+            p = c + 1;
+        }
+    }
+    if (prefixes.empty()) {
+        return;
+    }
+
+    // empty prefixes are ignored by QoreJavaApi.setStackTraceFilter()
+    LocalReference<jobjectArray> jprefixes = env.newObjectArray(prefixes.size(), Globals::classString);
+    for (size_t i = 0, e = prefixes.size(); i < e; ++i) {
+        QoreString prefix(prefixes[i].c_str(), QCS_UTF8);
+        prefix.trim();
+        env.setObjectArrayElement(jprefixes, i, env.newString(ModifiedUtf8String(prefix).c_str()));
+    }
+    jvalue jarg;
+    jarg.l = jprefixes;
+    env.callStaticVoidMethod(Globals::classQoreJavaApi, Globals::methodQoreJavaApiSetStackTraceFilter, &jarg);
+}
+
 static bool bootstrap = false;
 static bool already_initialized = false;
 static bool deferred_ns_init = false;
@@ -127,13 +196,50 @@ static bool deferred_ns_init = false;
 QoreStringNode* jni_module_init_finalize(bool system) {
     tclist.push(jni_thread_cleanup, nullptr);
 
+    // global options must be set before the class map is initialized, as initialization can continue in the
+    // background
+    {
+        ExceptionSink xsink;
+        ValueHolder v(qore_get_module_option("jni", "compat-types"), &xsink);
+        if (v) {
+            jni_compat_types = true;
+        }
+        ValueHolder lazy_import(qore_get_module_option("jni", "lazy-import"), &xsink);
+        if (lazy_import->getAsBool()) {
+            jni_lazy_import = true;
+        }
+        ValueHolder sticky_attach(qore_get_module_option("jni", "sticky-thread-attach"), &xsink);
+        if (sticky_attach->getAsBool()) {
+            jni::jni_sticky_thread_attach = true;
+        }
+    }
+
+    // check if Java threads calling Qore should stay attached until they terminate
+    {
+        QoreString val;
+        if (!SystemEnvironment::get("QORE_JNI_STICKY_THREAD_ATTACH", val) && q_parse_bool(val.c_str())) {
+            jni::jni_sticky_thread_attach = true;
+        }
+    }
+
+    // check if the class map should be initialized in the background
+    bool background = false;
+    {
+        QoreString val;
+        if (!SystemEnvironment::get("QORE_JNI_INIT_BACKGROUND", val)) {
+            background = q_parse_bool(val.c_str());
+        }
+    }
+
     try {
         QoreProgram* pgm = Globals::createJavaContextProgram();
         printd(5, "jni_module_init_finalize() pgm: %p\n", pgm);
         // issue #4006: ensure there is a program context for initialization
         QoreProgramContextHelper pgm_ctx(pgm);
 
-        qjcm.init(pgm, already_initialized);
+        jni_set_java_stack_options();
+
+        background = qjcm.init(pgm, already_initialized, background);
     } catch (jni::Exception& e) {
         tclist.pop(false);
         qore_release_signals(sig_vec, QORE_JNI_MODULE_NAME);
@@ -149,14 +255,11 @@ QoreStringNode* jni_module_init_finalize(bool system) {
         }
     }
 
-    ExceptionSink xsink;
-    ValueHolder v(qore_get_module_option("jni", "compat-types"), &xsink);
-    if (v) {
-        jni_compat_types = true;
+    // with background initialization, this flag is set by the initialization thread
+    if (!background) {
+        jni::jni_qore_init_done.store(true, std::memory_order_release);
     }
 
-    jni::jni_qore_init_done = true;
-
     printd(5, "jni_module_init_finalize() jni module init done\n");
     return nullptr;
 }
@@ -222,7 +325,7 @@ static QoreStringNode* jni_module_init() {
         return jni_module_init_finalize();
     }
 
-    jni::jni_qore_init_done = true;
+    jni::jni_qore_init_done.store(true, std::memory_order_release);
 
     return nullptr;
 }
@@ -235,6 +338,14 @@ static void jni_module_ns_init(QoreNamespace* rns, QoreNamespace* qns) {
         return;
     }
     assert(pgm->getRootNS() == rns);
+    // the Jni namespace can only be copied once the class map has been initialized; while background
+    // initialization is in progress (or if it failed), the namespace is added on first use by
+    // JniExternalProgramData::getCreateJniProgramData(), which waits for initialization and raises any error in the
+    // Program
+    if (!QoreJniClassMap::isInitComplete()) {
+        printd(LogLevel, "jni_module_ns_init() pgm: %p deferring Jni namespace until first use\n", pgm);
+        return;
+    }
     if (!pgm->getExternalData("jni")) {
         QoreNamespace* jnins = qjcm.getJniNs().copy();
         rns->addNamespace(jnins);
@@ -243,6 +354,12 @@ static void jni_module_ns_init(QoreNamespace* rns, QoreNamespace* qns) {
 }
 
 static void jni_module_delete() {
+    // make sure that any background initialization is complete
+    try {
+        QoreJniClassMap::waitForInit();
+    } catch (jni::Exception& e) {
+        e.ignore();
+    }
     // clear all objects from stored classes before destroying the JVM (releases all global references)
     Globals::clearGlobalContext();
     {
@@ -280,6 +397,12 @@ extern "C" QoreNamespace* jni_module_find_create_java_namespace(QoreString& arg,
 
 // exported function
 extern "C" int jni_module_import(ExceptionSink* xsink, QoreProgram* pgm, const char* import) {
+    try {
+        QoreJniClassMap::waitForInit();
+    } catch (jni::Exception& e) {
+        e.convert(xsink);
+        return -1;
+    }
     JniExternalProgramData* jpc = JniExternalProgramData::getCreateJniProgramData(pgm);
         //printd(5, "jni_module_import '%s' jpc: %p jnins: %p pgm: %p\n", import, jpc, jpc->getJniNamespace(), pgm);
     QoreString arg(import);
@@ -313,6 +436,13 @@ static void jni_module_parse_cmd(const QoreString& cmd, ExceptionSink* xsink) {
         return;
     }
 
+    try {
+        QoreJniClassMap::waitForInit();
+    } catch (jni::Exception& e) {
+        e.convert(xsink);
+        return;
+    }
+
     QoreString str(&cmd, p - cmd.c_str());
 
     QoreString arg(cmd);
@@ -512,7 +642,8 @@ static void qore_jni_mc_define_class(const QoreString& arg, QoreProgram* pgm, Jn
     //    static_cast<const unsigned char*>(byte_code->getPtr()), byte_code->size());
 
     // import the class immediately
-    qjcm.findCreateQoreClassInProgram(binary_name, java_name.c_str(), new Class(jcls), pgm);
+    JniQoreClass* qc = qjcm.findCreateQoreClassInProgram(binary_name, java_name.c_str(), new Class(jcls), pgm);
+    qjcm.checkPopulate(*qc, pgm);
 }
 
 static void qore_jni_mc_set_compat_types(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc) {
@@ -524,6 +655,15 @@ static void qore_jni_mc_set_compat_types(const QoreString& arg, QoreProgram* pgm
     jpc->overrideCompatTypes(compat_types);
 }
 
+static void qore_jni_mc_set_lazy_import(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc) {
+    assert(pgm);
+    assert(pgm->checkFeature(QORE_JNI_MODULE_NAME));
+    assert(jpc);
+
+    bool lazy_import = q_parse_bool(arg.c_str());
+    jpc->overrideLazyImport(lazy_import);
+}
+
 static void qore_jni_mc_set_property(const QoreString& arg, QoreProgram* pgm, JniExternalProgramData* jpc) {
     assert(pgm);
     assert(pgm->checkFeature(QORE_JNI_MODULE_NAME));
@@ -584,6 +724,7 @@ QoreClass* jni_class_handler(QoreNamespace* ns, const char* cname) {
     QoreProgram* pgm = ns->getProgram();
     assert(pgm);
     try {
+        QoreJniClassMap::waitForInit();
         Env env;
         QoreClass* qc = qjcm.findCreateQoreClass(env, cp.c_str(), pgm);
         printd(LogLevel, "jni_class_handler() cp: %s returning qc: %p\n", cp.c_str(), qc);
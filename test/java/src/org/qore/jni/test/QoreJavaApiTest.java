@@ -8,6 +8,15 @@ import org.qore.lang.reflection.*;
 
 import java.util.HashMap;
 import java.util.ArrayList;
+import java.util.Collections;
+import java.util.function.BiFunction;
+import java.util.function.Function;
+import java.util.function.Supplier;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
 import java.time.ZonedDateTime;
 import java.time.ZoneId;
 import java.math.BigDecimal;
@@ -254,6 +263,35 @@ public class QoreJavaApiTest {
         return new ClosureTest3();
     }
 
+    public static Function<Long, Long> getIncrementFunction() {
+        return x -> x + 1;
+    }
+
+    public static BiFunction<String, Long, String> getRepeatFunction() {
+        return (str, count) -> String.join("", Collections.nCopies(count.intValue(), str));
+    }
+
+    public interface StringFunction extends Function<String, String> {
+        String apply(String str);
+    }
+
+    public static StringFunction getStringFunction() {
+        return str -> str + "-x";
+    }
+
+    public static class ClosableSupplier implements AutoCloseable, Supplier<String> {
+        public void close() {
+        }
+
+        public String get() {
+            return "supplier";
+        }
+    }
+
+    public static ClosableSupplier getClosableSupplier() {
+        return new ClosableSupplier();
+    }
+
     @SuppressWarnings("unchecked")
     public static HashMap<String, Object>[] getCallStack() throws Throwable {
         return (HashMap<String, Object>[])QoreJavaApi.callFunction("gtcs", 50);
@@ -376,4 +414,101 @@ public class QoreJavaApiTest {
     public static void testCode(QoreClosure code, long val) throws Throwable {
         code.call(val);
     }
+
+    // calls the given function after recursing to the given depth
+    public static Object deepCallTest(String name, int depth) throws Throwable {
+        return depth > 0 ? deepCallTest(name, depth - 1) : QoreJavaApi.callFunction(name);
+    }
+
+    // throws an exception after recursing to the given depth
+    public static void deepThrowTest(int depth) {
+        if (depth > 0) {
+            deepThrowTest(depth - 1);
+            return;
+        }
+        throw new IllegalArgumentException("deep", new IllegalStateException("cause"));
+    }
+
+    public static String testMethodRef(QoreObject obj, String str, int count) throws Throwable {
+        QoreMethodRef ref = QoreMethodRef.forObject(obj, "getString");
+        String rv = null;
+        for (int i = 0; i < count; ++i) {
+            rv = (String)ref.call(obj, str);
+        }
+        return rv;
+    }
+
+    public static String testMethodRef(String class_name, String method_name, QoreObject obj) throws Throwable {
+        return (String)QoreMethodRef.forClass(class_name, method_name).call(obj);
+    }
+
+    // calls the method resolved in the given class on both objects, which can belong to subclasses
+    public static String testMethodRef(String class_name, String method_name, QoreObject obj0, QoreObject obj1,
+            int count) throws Throwable {
+        QoreMethodRef ref = QoreMethodRef.forClass(class_name, method_name);
+        String rv = null;
+        for (int i = 0; i < count; ++i) {
+            rv = (String)ref.call(obj0) + (String)ref.call(obj1);
+        }
+        return rv;
+    }
+
+    public static HashMap testStaticMethodRef(int count) throws Throwable {
+        QoreMethodRef ref = QoreMethodRef.forStatic("TestClass", "get");
+        HashMap rv = null;
+        for (int i = 0; i < count; ++i) {
+            rv = (HashMap)ref.callStatic(i);
+        }
+        return rv;
+    }
+
+    // calls the given function from a Java thread pool and returns the sum of the results
+    public static long threadPoolCallbackTest(String name, int threads, int count) throws Throwable {
+        QoreFunctionRef ref = QoreFunctionRef.resolve(name);
+        ExecutorService pool = Executors.newFixedThreadPool(threads);
+        try {
+            ArrayList<Future<Long>> futures = new ArrayList<Future<Long>>();
+            for (int t = 0; t < threads; ++t) {
+                futures.add(pool.submit(() -> {
+                    long rv = 0;
+                    for (int i = 0; i < count; ++i) {
+                        try {
+                            rv += (Long)ref.call(i);
+                        } catch (Throwable e) {
+                            throw new Exception(e);
+                        }
+                    }
+                    return rv;
+                }));
+            }
+            long rv = 0;
+            for (Future<Long> f : futures) {
+                rv += f.get();
+            }
+            return rv;
+        } finally {
+            pool.shutdown();
+            pool.awaitTermination(10, TimeUnit.SECONDS);
+        }
+    }
+
+    // calls the given task in a pool thread and returns the result
+    public static Object callTask(Callable<Object> task) throws Exception {
+        ExecutorService pool = Executors.newSingleThreadExecutor();
+        try {
+            return pool.submit(task).get();
+        } finally {
+            pool.shutdown();
+            pool.awaitTermination(10, TimeUnit.SECONDS);
+        }
+    }
+
+    public static long testFunctionRef(String name, int count) throws Throwable {
+        QoreFunctionRef ref = QoreFunctionRef.resolve(name);
+        long rv = 0;
+        for (int i = 0; i < count; ++i) {
+            rv += (Long)ref.call(i);
+        }
+        return rv;
+    }
 }